@@ -0,0 +1,69 @@
+#!/usr/bin/env bash
+#
+# Copyright (c) 2023 Nordic Semiconductor
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+# Run one scanner against a fleet of simulated Lesson 2 Exercise 2 beacons in BabbleSim.
+#
+# Build both images for the simulated board first:
+#   west build -b nrf52_bsim -d build_beacon ../l2_e2_sol -- -DEXTRA_CONF_FILE=fleet.conf
+#   west build -b nrf52_bsim -d build_scanner . -- -DEXTRA_CONF_FILE=fleet.conf
+#
+# fleet.conf sizes the scanner table for 500 beacons, so that no beacon is dropped
+# because the table is full.
+#
+# Usage: ./fleet_bsim.sh <beacon exe> <scanner exe> [beacons (10-500)] [seconds]
+#
+# The scanner output is written to scanner_<beacons>.log. Its periodic reports give the
+# advertisements processed per second, the counter updates lost and the update latency.
+
+set -euo pipefail
+
+if [ $# -lt 2 ]; then
+	echo "Usage: $0 <beacon exe> <scanner exe> [beacons (10-500)] [seconds]" >&2
+	exit 1
+fi
+
+: "${BSIM_OUT_PATH:?BSIM_OUT_PATH must point to the BabbleSim output directory}"
+
+BEACON_EXE=$(realpath "$1")
+SCANNER_EXE=$(realpath "$2")
+BEACONS=${3:-50}
+SECONDS_SIM=${4:-60}
+SIM_ID="bt_fund_fleet_${BEACONS}"
+
+if [ "$BEACONS" -lt 10 ] || [ "$BEACONS" -gt 500 ]; then
+	echo "Number of beacons must be between 10 and 500" >&2
+	exit 1
+fi
+
+# A full table drops new beacons, which would count as lost updates
+SCANNER_CONFIG="$(dirname "$SCANNER_EXE")/.config"
+if [ -f "$SCANNER_CONFIG" ]; then
+	TABLE_SIZE=$(sed -n 's/^CONFIG_SCANNER_TABLE_SIZE=//p' "$SCANNER_CONFIG")
+	if [ "$BEACONS" -gt $((TABLE_SIZE / 2)) ]; then
+		echo "Scanner table of $TABLE_SIZE entries is too small for $BEACONS beacons," \
+		     "build the scanner with fleet.conf" >&2
+		exit 1
+	fi
+fi
+
+LOG_FILE="$(pwd)/scanner_${BEACONS}.log"
+
+cd "${BSIM_OUT_PATH}/bin"
+
+# Device 0 is the scanner, devices 1..N are beacons with their own random seed so that
+# addresses and press timing differ between instances
+"$SCANNER_EXE" -s="$SIM_ID" -d=0 -rs=0 > "$LOG_FILE" 2>&1 &
+
+for i in $(seq 1 "$BEACONS"); do
+	"$BEACON_EXE" -s="$SIM_ID" -d="$i" -rs="$i" > /dev/null 2>&1 &
+done
+
+./bs_2G4_phy_v1 -s="$SIM_ID" -D=$((BEACONS + 1)) -sim_length=$((SECONDS_SIM * 1000000))
+
+wait
+
+echo "Scanner output: $LOG_FILE"
+grep -E "adv/s|counter updates lost" "$LOG_FILE" | tail -n 4
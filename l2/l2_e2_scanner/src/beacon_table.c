@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Beacon table
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "beacon_table.h"
+
+#define TABLE_SIZE CONFIG_SCANNER_TABLE_SIZE
+#define TABLE_MASK (TABLE_SIZE - 1)
+
+BUILD_ASSERT(TABLE_SIZE > 0 && (TABLE_SIZE & TABLE_MASK) == 0,
+	     "CONFIG_SCANNER_TABLE_SIZE must be a power of two");
+
+struct beacon_entry {
+	bt_addr_le_t addr;
+	uint16_t number_press;
+	/* A slot that was never used ends every probe sequence through it */
+	bool used;
+	uint32_t last_seen_ms;
+};
+
+static struct beacon_entry table[TABLE_SIZE];
+static struct k_spinlock lock;
+
+/* FNV-1a over the address type and value */
+static uint32_t addr_hash(const bt_addr_le_t *addr)
+{
+	uint32_t hash = 2166136261U;
+
+	hash = (hash ^ addr->type) * 16777619U;
+	for (size_t i = 0; i < sizeof(addr->a.val); i++) {
+		hash = (hash ^ addr->a.val[i]) * 16777619U;
+	}
+
+	return hash;
+}
+
+static bool entry_expired(const struct beacon_entry *entry, uint32_t now_ms)
+{
+	return (now_ms - entry->last_seen_ms) > CONFIG_SCANNER_DUP_TTL_MS;
+}
+
+enum beacon_table_result beacon_table_update(const bt_addr_le_t *addr, uint16_t number_press,
+					     uint32_t now_ms, uint16_t *prev_press)
+{
+	struct beacon_entry *free_entry = NULL;
+	enum beacon_table_result result;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	uint32_t idx = addr_hash(addr) & TABLE_MASK;
+
+	for (size_t probe = 0; probe < TABLE_SIZE; probe++, idx = (idx + 1) & TABLE_MASK) {
+		struct beacon_entry *entry = &table[idx];
+
+		if (!entry->used) {
+			if (!free_entry) {
+				free_entry = entry;
+			}
+			break;
+		}
+
+		if (bt_addr_le_eq(&entry->addr, addr)) {
+			if (entry_expired(entry, now_ms)) {
+				result = BEACON_TABLE_NEW;
+			} else if (entry->number_press == number_press) {
+				result = BEACON_TABLE_DUPLICATE;
+			} else {
+				result = BEACON_TABLE_UPDATED;
+				if (prev_press) {
+					*prev_press = entry->number_press;
+				}
+			}
+
+			entry->number_press = number_press;
+			entry->last_seen_ms = now_ms;
+			k_spin_unlock(&lock, key);
+			return result;
+		}
+
+		/* Expired entries stay in place so later entries remain reachable */
+		if (!free_entry && entry_expired(entry, now_ms)) {
+			free_entry = entry;
+		}
+	}
+
+	if (free_entry) {
+		bt_addr_le_copy(&free_entry->addr, addr);
+		free_entry->number_press = number_press;
+		free_entry->used = true;
+		free_entry->last_seen_ms = now_ms;
+		result = BEACON_TABLE_NEW;
+	} else {
+		result = BEACON_TABLE_FULL;
+	}
+
+	k_spin_unlock(&lock, key);
+	return result;
+}
+
+size_t beacon_table_count(uint32_t now_ms)
+{
+	size_t count = 0;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (size_t i = 0; i < TABLE_SIZE; i++) {
+		if (table[i].used && !entry_expired(&table[i], now_ms)) {
+			count++;
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+	return count;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BEACON_TABLE_H_
+#define BEACON_TABLE_H_
+
+/**@file
+ * @defgroup beacon_table Beacon table
+ * @{
+ * @brief Fixed-size table of beacons seen by the scanner.
+ *
+ * Beacons are kept in a statically allocated open-addressing hash table keyed
+ * on their address, with linear probing. An entry that has not been seen for
+ * CONFIG_SCANNER_DUP_TTL_MS expires and its slot is reused by the next new
+ * beacon on the same probe sequence.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <zephyr/types.h>
+#include <zephyr/bluetooth/addr.h>
+
+/** @brief Outcome of recording an advertisement. */
+enum beacon_table_result {
+	/** Beacon was not tracked or its entry had expired. */
+	BEACON_TABLE_NEW,
+	/** Beacon is tracked and its counter changed. */
+	BEACON_TABLE_UPDATED,
+	/** Same counter as last time, within the TTL. */
+	BEACON_TABLE_DUPLICATE,
+	/** Beacon is not tracked and there is no free slot. */
+	BEACON_TABLE_FULL,
+};
+
+/** @brief Record an advertisement.
+ *
+ * @param[in] addr Address of the beacon.
+ * @param[in] number_press Button counter carried by the advertisement.
+ * @param[in] now_ms Current uptime in milliseconds.
+ * @param[out] prev_press Previous counter of the beacon, set when the result is
+ *                        BEACON_TABLE_UPDATED. Can be NULL.
+ *
+ * @return What the advertisement meant for the table.
+ */
+enum beacon_table_result beacon_table_update(const bt_addr_le_t *addr, uint16_t number_press,
+					     uint32_t now_ms, uint16_t *prev_press);
+
+/** @brief Number of beacons seen within the TTL.
+ *
+ * @param[in] now_ms Current uptime in milliseconds.
+ */
+size_t beacon_table_count(uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* BEACON_TABLE_H_ */
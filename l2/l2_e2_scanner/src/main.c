@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Observer that collects the button counter of Lesson 2 Exercise 2
+ *  beacons.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/gap.h>
+#include <dk_buttons_and_leds.h>
+
+#include "beacon_table.h"
+
+/* Set to LOG_LEVEL_DBG to log every processed advertisement */
+#define SCANNER_LOG_LEVEL LOG_LEVEL_INF
+
+LOG_MODULE_REGISTER(Lesson2_Exercise2_Scanner, SCANNER_LOG_LEVEL);
+
+#define COMPANY_ID_CODE 0x0059
+
+/* Company ID followed by the number of button presses */
+#define MFG_DATA_LEN 4
+/* Fleet beacons (CONFIG_BEACON_FLEET) append the uptime of the last press */
+#define MFG_DATA_FLEET_LEN 8
+
+struct beacon_report {
+	int32_t number_press;
+	bool has_press_time;
+	uint32_t press_time;
+};
+
+#define RUN_STATUS_LED DK_LED1
+
+/* Window equal to the interval, the radio listens continuously */
+static const struct bt_le_scan_param *scan_param =
+	BT_LE_SCAN_PARAM(BT_LE_SCAN_TYPE_PASSIVE, BT_LE_SCAN_OPT_NONE, BT_GAP_SCAN_FAST_INTERVAL,
+			 BT_GAP_SCAN_FAST_INTERVAL);
+
+/* Advertisements in the current report interval */
+static atomic_t processed;
+static atomic_t duplicates;
+static atomic_t table_full;
+static atomic_t other;
+/* Counter steps that were never seen, lost to collisions or to the scanner */
+static atomic_t lost_updates;
+/* Counters that went back or jumped too far, a beacon that restarted */
+static atomic_t restarts;
+
+/* Counter update latency of fleet beacons in the current report interval */
+static struct k_spinlock latency_lock;
+static uint32_t latency_sum;
+static uint32_t latency_max;
+static uint32_t latency_count;
+
+static struct k_work_delayable report_work;
+
+static bool mfg_data_cb(struct bt_data *data, void *user_data)
+{
+	struct beacon_report *report = user_data;
+
+	if (data->type == BT_DATA_MANUFACTURER_DATA &&
+	    (data->data_len == MFG_DATA_LEN || data->data_len == MFG_DATA_FLEET_LEN) &&
+	    sys_get_le16(data->data) == COMPANY_ID_CODE) {
+		report->number_press = sys_get_le16(&data->data[2]);
+		if (data->data_len == MFG_DATA_FLEET_LEN) {
+			report->has_press_time = true;
+			report->press_time = sys_get_le32(&data->data[4]);
+		}
+		return false;
+	}
+
+	return true;
+}
+
+static void record_latency(uint32_t latency_ms)
+{
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+	latency_sum += latency_ms;
+	latency_max = MAX(latency_max, latency_ms);
+	latency_count++;
+
+	k_spin_unlock(&latency_lock, key);
+}
+
+static void device_found(const bt_addr_le_t *addr, int8_t rssi, uint8_t type,
+			 struct net_buf_simple *ad)
+{
+	struct beacon_report report = { .number_press = -1 };
+	uint32_t now_ms = k_uptime_get_32();
+	char addr_str[BT_ADDR_LE_STR_LEN];
+	uint16_t prev_press;
+	uint16_t gap;
+
+	/* Parses the buffer in place, nothing is copied or allocated */
+	bt_data_parse(ad, mfg_data_cb, &report);
+	if (report.number_press < 0) {
+		atomic_inc(&other);
+		return;
+	}
+
+	switch (beacon_table_update(addr, report.number_press, now_ms, &prev_press)) {
+	case BEACON_TABLE_UPDATED:
+		/* Modulo 2^16, so a counter that went back shows up as a huge gap */
+		gap = report.number_press - prev_press - 1;
+		if (gap < CONFIG_SCANNER_MAX_COUNTER_GAP) {
+			atomic_add(&lost_updates, gap);
+		} else {
+			/* The table now holds the new value, later updates count from there */
+			atomic_inc(&restarts);
+		}
+		if (report.has_press_time) {
+			record_latency(now_ms - report.press_time);
+		}
+		__fallthrough;
+	case BEACON_TABLE_NEW:
+		atomic_inc(&processed);
+		if (SCANNER_LOG_LEVEL >= LOG_LEVEL_DBG) {
+			bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
+			LOG_DBG("%s: %d presses (RSSI %d)", addr_str, report.number_press, rssi);
+		}
+		break;
+	case BEACON_TABLE_DUPLICATE:
+		atomic_inc(&duplicates);
+		break;
+	case BEACON_TABLE_FULL:
+		atomic_inc(&table_full);
+		break;
+	}
+}
+
+static void report_work_handler(struct k_work *work)
+{
+	uint32_t interval_ms = CONFIG_SCANNER_REPORT_INTERVAL_MS;
+	uint32_t n_processed = atomic_clear(&processed);
+	uint32_t n_dropped = atomic_clear(&duplicates) + atomic_clear(&table_full);
+	uint32_t n_other = atomic_clear(&other);
+	uint32_t n_lost = atomic_clear(&lost_updates);
+	uint32_t n_restarts = atomic_clear(&restarts);
+	uint32_t lat_sum, lat_max, lat_count;
+	k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+	lat_sum = latency_sum;
+	lat_max = latency_max;
+	lat_count = latency_count;
+	latency_sum = 0;
+	latency_max = 0;
+	latency_count = 0;
+	k_spin_unlock(&latency_lock, key);
+
+	LOG_INF("%u adv/s processed, %u adv/s dropped, %u adv/s from other devices, %zu beacons",
+		n_processed * 1000U / interval_ms, n_dropped * 1000U / interval_ms,
+		n_other * 1000U / interval_ms, beacon_table_count(k_uptime_get_32()));
+
+	if (n_lost || n_restarts || lat_count) {
+		LOG_INF("%u counter updates lost, %u beacon restarts, update latency %u ms average, "
+			"%u ms max", n_lost, n_restarts, lat_count ? lat_sum / lat_count : 0, lat_max);
+	}
+
+	k_work_schedule(&report_work, K_MSEC(interval_ms));
+}
+
+int main(void)
+{
+	int blink_status = 0;
+	int err;
+
+	LOG_INF("Starting Lesson 2 - Exercise 2 scanner\n");
+
+	err = dk_leds_init();
+	if (err) {
+		LOG_ERR("LEDs init failed (err %d)\n", err);
+		return -1;
+	}
+
+	err = bt_enable(NULL);
+	if (err) {
+		LOG_ERR("Bluetooth init failed (err %d)\n", err);
+		return -1;
+	}
+
+	LOG_INF("Bluetooth initialized\n");
+
+	/* Duplicate filtering is done by the beacon table, the controller would
+	 * also drop advertisements whose counter changed.
+	 */
+	err = bt_le_scan_start(scan_param, device_found);
+	if (err) {
+		LOG_ERR("Scanning failed to start (err %d)\n", err);
+		return -1;
+	}
+
+	LOG_INF("Scanning successfully started\n");
+
+	k_work_init_delayable(&report_work, report_work_handler);
+	k_work_schedule(&report_work, K_MSEC(CONFIG_SCANNER_REPORT_INTERVAL_MS));
+
+	for (;;) {
+		dk_set_led(RUN_STATUS_LED, (++blink_status) % 2);
+		k_sleep(K_MSEC(1000));
+	}
+}
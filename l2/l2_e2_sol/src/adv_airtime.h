@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef ADV_AIRTIME_H_
+#define ADV_AIRTIME_H_
+
+/**@file
+ * @defgroup adv_airtime Advertising on-air time estimation
+ * @{
+ * @brief Estimate how long the radio transmits per advertising event.
+ *
+ * The estimate covers the advertising PDUs only. Scan requests, scan
+ * responses and the inter-frame spacing are not included.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <zephyr/types.h>
+
+/** @brief On-air time of one PDU.
+ *
+ * @param[in] phy BT_GAP_LE_PHY_1M, BT_GAP_LE_PHY_2M or BT_GAP_LE_PHY_CODED (S8).
+ * @param[in] payload_len Length of the PDU payload in bytes, without the header.
+ *
+ * @return Time in microseconds.
+ */
+uint32_t adv_airtime_pdu_us(uint8_t phy, size_t payload_len);
+
+/** @brief On-air time of one legacy advertising event on three channels.
+ *
+ * @param[in] ad_len Length of the encoded advertising data.
+ *
+ * @return Time in microseconds.
+ */
+uint32_t adv_airtime_legacy_event_us(size_t ad_len);
+
+/** @brief On-air time of one extended advertising event.
+ *
+ * Counts ADV_EXT_IND on the three primary channels and the AUX_ADV_IND and
+ * AUX_CHAIN_IND PDUs needed to carry the advertising data on the secondary
+ * channel.
+ *
+ * @param[in] primary_phy PHY of the primary channels.
+ * @param[in] secondary_phy PHY of the secondary channel.
+ * @param[in] ad_len Length of the encoded advertising data.
+ *
+ * @return Time in microseconds.
+ */
+uint32_t adv_airtime_ext_event_us(uint8_t primary_phy, uint8_t secondary_phy, size_t ad_len);
+
+/** @brief Airtime of a set in hundredths of a percent.
+ *
+ * @param[in] event_us On-air time per advertising event.
+ * @param[in] interval Advertising interval in 0.625 ms units.
+ *
+ * @return Share of time the radio transmits, 10000 being 100 %.
+ */
+uint32_t adv_airtime_duty(uint32_t event_us, uint32_t interval);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ADV_AIRTIME_H_ */
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Advertising data update coalescing
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "adv_coalesce.h"
+
+LOG_MODULE_DECLARE(Lesson2_Exercise2);
+
+static adv_coalesce_push_t push_cb;
+static uint8_t cmds_per_push;
+static k_ticks_t interval_ticks;
+static int64_t last_push_ticks;
+static uint32_t requests;
+static uint32_t pushes;
+static struct k_work_delayable push_work;
+
+static void push_work_handler(struct k_work *work)
+{
+	int err;
+
+	last_push_ticks = k_uptime_ticks();
+
+	err = push_cb();
+	if (err) {
+		/* The controller still has the old data, try again after an interval */
+		LOG_ERR("Advertising data update failed (err %d)", err);
+		k_work_schedule(&push_work, K_TICKS(interval_ticks));
+		return;
+	}
+
+	pushes++;
+
+	LOG_INF("Advertising data updated: %u requests, %u HCI commands saved", requests,
+		adv_coalesce_saved());
+}
+
+void adv_coalesce_init(adv_coalesce_push_t push, uint8_t push_cmds, k_timeout_t interval)
+{
+	push_cb = push;
+	cmds_per_push = push_cmds;
+	interval_ticks = interval.ticks;
+	/* Allow the first update to be pushed right away */
+	last_push_ticks = k_uptime_ticks() - interval_ticks;
+	k_work_init_delayable(&push_work, push_work_handler);
+}
+
+void adv_coalesce_mark_dirty(void)
+{
+	int64_t next_ticks = last_push_ticks + interval_ticks;
+	int64_t now_ticks = k_uptime_ticks();
+
+	requests++;
+
+	/* Does nothing if a push is already scheduled, that push will carry this change */
+	k_work_schedule(&push_work, K_TICKS(MAX(next_ticks - now_ticks, 0)));
+}
+
+uint32_t adv_coalesce_saved(void)
+{
+	return (requests - pushes) * cmds_per_push;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef ADV_COALESCE_H_
+#define ADV_COALESCE_H_
+
+/**@file
+ * @defgroup adv_coalesce Advertising data update coalescing
+ * @{
+ * @brief Rate limit advertising data updates to one per advertising interval.
+ *
+ * The controller only sends the data that is current at the next advertising
+ * event, so updating it more often than once per interval only costs HCI
+ * commands. Callers mark the data dirty, and the push callback is run from
+ * the system workqueue at most once per interval. It always sends the
+ * latest state, and is run again an interval later if it fails.
+ *
+ * The API is meant to be called from the system workqueue, where the DK
+ * library runs its button handler.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr/kernel.h>
+
+/** @brief Callback that sends the current advertising data to the controller.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+typedef int (*adv_coalesce_push_t)(void);
+
+/** @brief Initialize the coalescer.
+ *
+ * @param[in] push Callback that sends the advertising data.
+ * @param[in] push_cmds Number of HCI commands one push sends, for example
+ *                      2 when it sets advertising and scan response data.
+ * @param[in] interval Minimum time between two pushes, normally the
+ *                     advertising interval.
+ */
+void adv_coalesce_init(adv_coalesce_push_t push, uint8_t push_cmds, k_timeout_t interval);
+
+/** @brief Mark the advertising data as changed.
+ *
+ * The data is pushed right away if the previous push is at least one
+ * interval old, otherwise when the interval has passed.
+ */
+void adv_coalesce_mark_dirty(void);
+
+/** @brief Number of HCI commands saved by the update requests that were not pushed. */
+uint32_t adv_coalesce_saved(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ADV_COALESCE_H_ */
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Concurrent extended advertising sets
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gap.h>
+
+#include "ext_adv.h"
+#include "adv_airtime.h"
+
+LOG_MODULE_DECLARE(Lesson2_Exercise2);
+
+#define DEVICE_NAME CONFIG_BT_DEVICE_NAME
+#define DEVICE_NAME_LEN (sizeof(DEVICE_NAME) - 1)
+
+#define CONN_ADV_INT_MIN BT_GAP_ADV_FAST_INT_MIN_2 /* 100 ms */
+#define CONN_ADV_INT_MAX BT_GAP_ADV_FAST_INT_MAX_2 /* 150 ms */
+#define BEACON_ADV_INT_MIN 800 /* 500 ms */
+#define BEACON_ADV_INT_MAX 801 /* 500.625 ms */
+
+#if defined(CONFIG_BEACON_EXT_ADV_PHY_CODED)
+#define EXT_ADV_PHY_OPT BT_LE_ADV_OPT_CODED
+#define EXT_ADV_PRIMARY_PHY BT_GAP_LE_PHY_CODED
+#define EXT_ADV_SECONDARY_PHY BT_GAP_LE_PHY_CODED
+#elif defined(CONFIG_BEACON_EXT_ADV_PHY_1M)
+#define EXT_ADV_PHY_OPT BT_LE_ADV_OPT_NO_2M
+#define EXT_ADV_PRIMARY_PHY BT_GAP_LE_PHY_1M
+#define EXT_ADV_SECONDARY_PHY BT_GAP_LE_PHY_1M
+#else
+#define EXT_ADV_PHY_OPT BT_LE_ADV_OPT_NONE
+#define EXT_ADV_PRIMARY_PHY BT_GAP_LE_PHY_1M
+#define EXT_ADV_SECONDARY_PHY BT_GAP_LE_PHY_2M
+#endif
+
+static const struct bt_le_adv_param *conn_adv_param =
+	BT_LE_ADV_PARAM(BT_LE_ADV_OPT_EXT_ADV | BT_LE_ADV_OPT_CONN | EXT_ADV_PHY_OPT,
+			CONN_ADV_INT_MIN, CONN_ADV_INT_MAX, NULL);
+
+static const struct bt_le_adv_param *beacon_adv_param =
+	BT_LE_ADV_PARAM(BT_LE_ADV_OPT_EXT_ADV | EXT_ADV_PHY_OPT, BEACON_ADV_INT_MIN,
+			BEACON_ADV_INT_MAX, NULL);
+
+static const struct bt_data conn_ad[] = {
+	BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+	BT_DATA(BT_DATA_NAME_COMPLETE, DEVICE_NAME, DEVICE_NAME_LEN),
+};
+
+static struct bt_le_ext_adv *conn_set;
+static struct bt_le_ext_adv *beacon_set;
+static struct k_work conn_adv_work;
+
+static void log_airtime(const char *name, size_t ad_len, uint32_t interval)
+{
+	uint32_t event_us = adv_airtime_ext_event_us(EXT_ADV_PRIMARY_PHY, EXT_ADV_SECONDARY_PHY,
+						     ad_len);
+	uint32_t duty = adv_airtime_duty(event_us, interval);
+
+	LOG_INF("%s set: %zu bytes AD, %u us on air per event, %u.%02u %% airtime", name, ad_len,
+		event_us, duty / 100U, duty % 100U);
+}
+
+static void conn_adv_work_handler(struct k_work *work)
+{
+	int err = bt_le_ext_adv_start(conn_set, BT_LE_EXT_ADV_START_DEFAULT);
+
+	if (err) {
+		LOG_ERR("Connectable set failed to start (err %d)", err);
+	}
+}
+
+static void recycled_cb(void)
+{
+	/* The connectable set stops when a central connects, the beacon set keeps running */
+	k_work_submit(&conn_adv_work);
+}
+
+BT_CONN_CB_DEFINE(ext_adv_conn_callbacks) = {
+	.recycled = recycled_cb,
+};
+
+int ext_adv_start(const struct bt_data *beacon_ad, size_t beacon_ad_len)
+{
+	int err;
+
+	k_work_init(&conn_adv_work, conn_adv_work_handler);
+
+	err = bt_le_ext_adv_create(conn_adv_param, NULL, &conn_set);
+	if (err) {
+		LOG_ERR("Failed to create connectable set (err %d)", err);
+		return err;
+	}
+
+	err = bt_le_ext_adv_set_data(conn_set, conn_ad, ARRAY_SIZE(conn_ad), NULL, 0);
+	if (err) {
+		LOG_ERR("Failed to set connectable set data (err %d)", err);
+		return err;
+	}
+
+	err = bt_le_ext_adv_create(beacon_adv_param, NULL, &beacon_set);
+	if (err) {
+		LOG_ERR("Failed to create beacon set (err %d)", err);
+		return err;
+	}
+
+	err = bt_le_ext_adv_set_data(beacon_set, beacon_ad, beacon_ad_len, NULL, 0);
+	if (err) {
+		LOG_ERR("Failed to set beacon set data (err %d)", err);
+		return err;
+	}
+
+	err = bt_le_ext_adv_start(conn_set, BT_LE_EXT_ADV_START_DEFAULT);
+	if (err) {
+		LOG_ERR("Connectable set failed to start (err %d)", err);
+		return err;
+	}
+
+	err = bt_le_ext_adv_start(beacon_set, BT_LE_EXT_ADV_START_DEFAULT);
+	if (err) {
+		LOG_ERR("Beacon set failed to start (err %d)", err);
+		return err;
+	}
+
+	log_airtime("Connectable", bt_data_get_len(conn_ad, ARRAY_SIZE(conn_ad)), CONN_ADV_INT_MIN);
+	log_airtime("Beacon", bt_data_get_len(beacon_ad, beacon_ad_len), BEACON_ADV_INT_MIN);
+
+	return 0;
+}
+
+int ext_adv_update_beacon(const struct bt_data *beacon_ad, size_t beacon_ad_len)
+{
+	return bt_le_ext_adv_set_data(beacon_set, beacon_ad, beacon_ad_len, NULL, 0);
+}
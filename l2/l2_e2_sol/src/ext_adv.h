@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef EXT_ADV_H_
+#define EXT_ADV_H_
+
+/**@file
+ * @defgroup ext_adv Concurrent extended advertising sets
+ * @{
+ * @brief Run a connectable set and a non-connectable beacon set at the same time.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <zephyr/bluetooth/bluetooth.h>
+
+/** @brief Create and start both advertising sets.
+ *
+ * The on-air time of each set is logged once the sets are started.
+ *
+ * @param[in] beacon_ad Advertising data of the beacon set.
+ * @param[in] beacon_ad_len Number of elements in @p beacon_ad.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int ext_adv_start(const struct bt_data *beacon_ad, size_t beacon_ad_len);
+
+/** @brief Replace the advertising data of the beacon set.
+ *
+ * @param[in] beacon_ad Advertising data of the beacon set.
+ * @param[in] beacon_ad_len Number of elements in @p beacon_ad.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int ext_adv_update_beacon(const struct bt_data *beacon_ad, size_t beacon_ad_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* EXT_ADV_H_ */
@@ -6,10 +6,16 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/gap.h>
+#include <zephyr/bluetooth/addr.h>
 #include <dk_buttons_and_leds.h>
 
+#include "ext_adv.h"
+#include "per_adv.h"
+#include "adv_coalesce.h"
+
 /* STEP 2.1 - Declare the Company identifier (Company ID) */
 #define COMPANY_ID_CODE 0x0059
 
@@ -17,10 +23,16 @@
 typedef struct adv_mfg_data {
 	uint16_t company_code; /* Company Identifier Code. */
 	uint16_t number_press; /* Number of times Button 1 is pressed */
+#if defined(CONFIG_BEACON_FLEET)
+	uint32_t press_time; /* Uptime of the last press in ms, for latency measurements */
+#endif
 } adv_mfg_data_type;
 
 #define USER_BUTTON DK_BTN1_MSK
 
+/* Push at most one advertising data update per advertising interval */
+#define ADV_UPDATE_INTERVAL K_MSEC(500)
+
 /* STEP 1 - Create an LE Advertising Parameters variable */
 static const struct bt_le_adv_param *adv_param =
 	BT_LE_ADV_PARAM(BT_LE_ADV_OPT_NONE, /* No options specified */
@@ -52,14 +64,91 @@ static const struct bt_data ad[] = {
 static const struct bt_data sd[] = {
 	BT_DATA(BT_DATA_URI, url_data, sizeof(url_data)),
 };
+
+/* Extended advertising is not limited to 31 bytes, so the beacon set carries
+ * the scan response content in the same payload.
+ */
+static const struct bt_data ext_ad[] = {
+	BT_DATA_BYTES(BT_DATA_FLAGS, BT_LE_AD_NO_BREDR),
+	BT_DATA(BT_DATA_NAME_COMPLETE, DEVICE_NAME, DEVICE_NAME_LEN),
+	BT_DATA(BT_DATA_MANUFACTURER_DATA, (unsigned char *)&adv_mfg_data, sizeof(adv_mfg_data)),
+	BT_DATA(BT_DATA_URI, url_data, sizeof(url_data)),
+};
+
+/* In periodic advertising mode the extended advertising data only has to let
+ * scanners find the train, the button counter is sent in the periodic data.
+ */
+static const struct bt_data per_ext_ad[] = {
+	BT_DATA(BT_DATA_NAME_COMPLETE, DEVICE_NAME, DEVICE_NAME_LEN),
+	BT_DATA(BT_DATA_URI, url_data, sizeof(url_data)),
+};
+
+static const struct bt_data per_ad[] = {
+	BT_DATA(BT_DATA_MANUFACTURER_DATA, (unsigned char *)&adv_mfg_data, sizeof(adv_mfg_data)),
+};
+
+/* Legacy advertising sets both the advertising and the scan response data */
+#define ADV_PUSH_HCI_CMDS                                                                          \
+	((IS_ENABLED(CONFIG_BEACON_EXT_ADV) || IS_ENABLED(CONFIG_BEACON_PER_ADV)) ? 1 : 2)
+
+static int push_adv_data(void)
+{
+	if (IS_ENABLED(CONFIG_BEACON_EXT_ADV)) {
+		return ext_adv_update_beacon(ext_ad, ARRAY_SIZE(ext_ad));
+	} else if (IS_ENABLED(CONFIG_BEACON_PER_ADV)) {
+		return per_adv_update(per_ad, ARRAY_SIZE(per_ad));
+	}
+
+	return bt_le_adv_update_data(ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+}
+
 /* STEP 5 - Add the definition of callback function and update the advertising data dynamically */
 static void button_changed(uint32_t button_state, uint32_t has_changed)
 {
 	if (has_changed & button_state & USER_BUTTON) {
 		adv_mfg_data.number_press += 1;
-		bt_le_adv_update_data(ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+		adv_coalesce_mark_dirty();
 	}
 }
+
+#if defined(CONFIG_BEACON_FLEET)
+static struct k_work_delayable fleet_press_work;
+
+static k_timeout_t fleet_press_delay(void)
+{
+	uint32_t span = CONFIG_BEACON_FLEET_PRESS_MAX_MS - CONFIG_BEACON_FLEET_PRESS_MIN_MS + 1;
+
+	return K_MSEC(CONFIG_BEACON_FLEET_PRESS_MIN_MS + sys_rand32_get() % span);
+}
+
+/* Simulated Button 1 press, runs on the system workqueue like the button handler */
+static void fleet_press_work_handler(struct k_work *work)
+{
+	adv_mfg_data.press_time = k_uptime_get_32();
+	button_changed(USER_BUTTON, USER_BUTTON);
+
+	k_work_schedule(&fleet_press_work, fleet_press_delay());
+}
+
+/* Every fleet member needs its own address, give identity 0 a random static one */
+static int fleet_id_create(void)
+{
+	bt_addr_le_t addr = { .type = BT_ADDR_LE_RANDOM };
+	int err;
+
+	sys_rand_get(addr.a.val, sizeof(addr.a.val));
+	BT_ADDR_SET_STATIC(&addr.a);
+
+	err = bt_id_create(&addr, NULL);
+	if (err < 0) {
+		LOG_ERR("Creating fleet identity failed (err %d)", err);
+		return err;
+	}
+
+	return 0;
+}
+#endif
+
 /* STEP 4.1 - Define the initialization function of the buttons and setup interrupt.  */
 static int init_button(void)
 {
@@ -85,6 +174,8 @@ int main(void)
 		LOG_ERR("LEDs init failed (err %d)\n", err);
 		return -1;
 	}
+	adv_coalesce_init(push_adv_data, ADV_PUSH_HCI_CMDS, ADV_UPDATE_INTERVAL);
+
 	/* STEP 4.2 - Setup buttons on your board  */
 	err = init_button();
 	if (err) {
@@ -92,6 +183,13 @@ int main(void)
 		return -1;
 	}
 
+#if defined(CONFIG_BEACON_FLEET)
+	err = fleet_id_create();
+	if (err) {
+		return -1;
+	}
+#endif
+
 	err = bt_enable(NULL);
 	if (err) {
 		LOG_ERR("Bluetooth init failed (err %d)\n", err);
@@ -100,7 +198,13 @@ int main(void)
 
 	LOG_INF("Bluetooth initialized\n");
 
-	err = bt_le_adv_start(adv_param, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+	if (IS_ENABLED(CONFIG_BEACON_EXT_ADV)) {
+		err = ext_adv_start(ext_ad, ARRAY_SIZE(ext_ad));
+	} else if (IS_ENABLED(CONFIG_BEACON_PER_ADV)) {
+		err = per_adv_start(per_ext_ad, ARRAY_SIZE(per_ext_ad), per_ad, ARRAY_SIZE(per_ad));
+	} else {
+		err = bt_le_adv_start(adv_param, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+	}
 	if (err) {
 		LOG_ERR("Advertising failed to start (err %d)\n", err);
 		return -1;
@@ -108,6 +212,11 @@ int main(void)
 
 	LOG_INF("Advertising successfully started\n");
 
+#if defined(CONFIG_BEACON_FLEET)
+	k_work_init_delayable(&fleet_press_work, fleet_press_work_handler);
+	k_work_schedule(&fleet_press_work, fleet_press_delay());
+#endif
+
 	for (;;) {
 		dk_set_led(RUN_STATUS_LED, (++blink_status) % 2);
 		k_sleep(K_MSEC(RUN_LED_BLINK_INTERVAL));
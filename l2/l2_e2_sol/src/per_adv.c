@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Periodic advertising
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/gap.h>
+
+#include "per_adv.h"
+#include "adv_airtime.h"
+
+LOG_MODULE_DECLARE(Lesson2_Exercise2);
+
+#define EXT_ADV_INT_MIN 1600 /* 1 s */
+#define EXT_ADV_INT_MAX 1601 /* 1.000625 s */
+#define PER_ADV_INT CONFIG_BEACON_PER_ADV_INTERVAL /* 1.25 ms units */
+
+/* Extended header length/AdvMode and flags of AUX_SYNC_IND */
+#define AUX_SYNC_IND_HDR_LEN (1 + 1)
+
+/* Periodic advertising is only allowed on non-connectable, non-scannable sets. The
+ * extended advertising interval only matters for how fast a scanner finds the train.
+ */
+static const struct bt_le_adv_param *ext_adv_param =
+	BT_LE_ADV_PARAM(BT_LE_ADV_OPT_EXT_ADV, EXT_ADV_INT_MIN, EXT_ADV_INT_MAX, NULL);
+
+static const struct bt_le_per_adv_param *per_adv_param =
+	BT_LE_PER_ADV_PARAM(PER_ADV_INT, PER_ADV_INT, BT_LE_PER_ADV_OPT_NONE);
+
+static struct bt_le_ext_adv *adv_set;
+
+static void log_airtime(size_t ad_len, size_t per_ad_len)
+{
+	uint32_t ext_us = adv_airtime_ext_event_us(BT_GAP_LE_PHY_1M, BT_GAP_LE_PHY_2M, ad_len);
+	uint32_t per_us = adv_airtime_pdu_us(BT_GAP_LE_PHY_2M, AUX_SYNC_IND_HDR_LEN + per_ad_len);
+	/* The periodic interval is in 1.25 ms units, adv_airtime_duty() takes 0.625 ms units */
+	uint32_t ext_duty = adv_airtime_duty(ext_us, EXT_ADV_INT_MIN);
+	uint32_t per_duty = adv_airtime_duty(per_us, 2U * PER_ADV_INT);
+
+	LOG_INF("Extended advertising: %u us per event, %u.%02u %% airtime", ext_us,
+		ext_duty / 100U, ext_duty % 100U);
+	LOG_INF("Periodic advertising: %u us per event every %u ms, %u.%02u %% airtime", per_us,
+		PER_ADV_INT * 5U / 4U, per_duty / 100U, per_duty % 100U);
+}
+
+int per_adv_start(const struct bt_data *ad, size_t ad_len, const struct bt_data *per_ad,
+		  size_t per_ad_len)
+{
+	int err;
+
+	err = bt_le_ext_adv_create(ext_adv_param, NULL, &adv_set);
+	if (err) {
+		LOG_ERR("Failed to create advertising set (err %d)", err);
+		return err;
+	}
+
+	err = bt_le_ext_adv_set_data(adv_set, ad, ad_len, NULL, 0);
+	if (err) {
+		LOG_ERR("Failed to set advertising data (err %d)", err);
+		return err;
+	}
+
+	err = bt_le_per_adv_set_param(adv_set, per_adv_param);
+	if (err) {
+		LOG_ERR("Failed to set periodic advertising parameters (err %d)", err);
+		return err;
+	}
+
+	err = bt_le_per_adv_set_data(adv_set, per_ad, per_ad_len);
+	if (err) {
+		LOG_ERR("Failed to set periodic advertising data (err %d)", err);
+		return err;
+	}
+
+	err = bt_le_per_adv_start(adv_set);
+	if (err) {
+		LOG_ERR("Periodic advertising failed to start (err %d)", err);
+		return err;
+	}
+
+	/* The SyncInfo field pointing to the train is only sent while the set advertises */
+	err = bt_le_ext_adv_start(adv_set, BT_LE_EXT_ADV_START_DEFAULT);
+	if (err) {
+		LOG_ERR("Extended advertising failed to start (err %d)", err);
+		return err;
+	}
+
+	log_airtime(bt_data_get_len(ad, ad_len), bt_data_get_len(per_ad, per_ad_len));
+
+	return 0;
+}
+
+int per_adv_update(const struct bt_data *per_ad, size_t per_ad_len)
+{
+	return bt_le_per_adv_set_data(adv_set, per_ad, per_ad_len);
+}
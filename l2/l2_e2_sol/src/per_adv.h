@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef PER_ADV_H_
+#define PER_ADV_H_
+
+/**@file
+ * @defgroup per_adv Periodic advertising
+ * @{
+ * @brief Broadcast the beacon data in a periodic advertising train.
+ *
+ * Scanners synchronize to the train once and then receive every update at a
+ * known time, without scanning or sending scan requests.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <zephyr/bluetooth/bluetooth.h>
+
+/** @brief Create the advertising set and start periodic advertising.
+ *
+ * The extended advertising data only lets scanners find the train, the
+ * periodic advertising data carries the payload.
+ *
+ * @param[in] ad Extended advertising data.
+ * @param[in] ad_len Number of elements in @p ad.
+ * @param[in] per_ad Periodic advertising data.
+ * @param[in] per_ad_len Number of elements in @p per_ad.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int per_adv_start(const struct bt_data *ad, size_t ad_len, const struct bt_data *per_ad,
+		  size_t per_ad_len);
+
+/** @brief Replace the periodic advertising data.
+ *
+ * @param[in] per_ad Periodic advertising data.
+ * @param[in] per_ad_len Number of elements in @p per_ad.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int per_adv_update(const struct bt_data *per_ad, size_t per_ad_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* PER_ADV_H_ */
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Observer that synchronizes to the periodic advertising train of the
+ *  Lesson 2 Exercise 2 beacon built with per_adv.conf.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/gap.h>
+#include <dk_buttons_and_leds.h>
+
+LOG_MODULE_REGISTER(Lesson2_Exercise2_Sync, LOG_LEVEL_INF);
+
+/* Beacon to synchronize to */
+#define TARGET_NAME "Nordic_Beacon"
+#define TARGET_NAME_LEN (sizeof(TARGET_NAME) - 1)
+#define COMPANY_ID_CODE 0x0059
+
+/* Company ID followed by the number of button presses */
+#define MFG_DATA_LEN 4
+
+#define SYNC_STATUS_LED DK_LED1
+#define SYNC_CREATE_TIMEOUT K_SECONDS(10)
+
+/* Periodic advertising interval is in 1.25 ms units */
+#define PER_INTERVAL_TO_MS(interval) ((uint32_t)(interval) * 5U / 4U)
+
+static K_SEM_DEFINE(sem_per_adv, 0, 1);
+static K_SEM_DEFINE(sem_per_sync, 0, 1);
+static K_SEM_DEFINE(sem_per_sync_lost, 0, 1);
+
+static bt_addr_le_t per_addr;
+static uint8_t per_sid;
+static uint16_t per_interval;
+static bool per_adv_found;
+
+static int64_t scan_start_time;
+static int32_t number_press;
+static bool number_press_valid;
+
+static bool name_match_cb(struct bt_data *data, void *user_data)
+{
+	bool *match = user_data;
+
+	if (data->type == BT_DATA_NAME_COMPLETE || data->type == BT_DATA_NAME_SHORTENED) {
+		*match = (data->data_len == TARGET_NAME_LEN) &&
+			 !memcmp(data->data, TARGET_NAME, TARGET_NAME_LEN);
+		return false;
+	}
+
+	return true;
+}
+
+static void scan_recv(const struct bt_le_scan_recv_info *info, struct net_buf_simple *buf)
+{
+	bool match = false;
+
+	/* Only extended advertising with a SyncInfo field has a periodic interval */
+	if (per_adv_found || info->interval == 0) {
+		return;
+	}
+
+	bt_data_parse(buf, name_match_cb, &match);
+	if (!match) {
+		return;
+	}
+
+	per_adv_found = true;
+	bt_addr_le_copy(&per_addr, info->addr);
+	per_sid = info->sid;
+	per_interval = info->interval;
+
+	k_sem_give(&sem_per_adv);
+}
+
+static struct bt_le_scan_cb scan_callbacks = {
+	.recv = scan_recv,
+};
+
+static bool mfg_data_cb(struct bt_data *data, void *user_data)
+{
+	int32_t *value = user_data;
+
+	if (data->type == BT_DATA_MANUFACTURER_DATA && data->data_len == MFG_DATA_LEN &&
+	    sys_get_le16(data->data) == COMPANY_ID_CODE) {
+		*value = sys_get_le16(&data->data[2]);
+		return false;
+	}
+
+	return true;
+}
+
+static void sync_cb(struct bt_le_per_adv_sync *sync,
+		    struct bt_le_per_adv_sync_synced_info *info)
+{
+	char addr[BT_ADDR_LE_STR_LEN];
+
+	bt_addr_le_to_str(info->addr, addr, sizeof(addr));
+	LOG_INF("Synced to %s SID %u, interval %u ms, %lld ms after scan start", addr, info->sid,
+		PER_INTERVAL_TO_MS(info->interval), k_uptime_get() - scan_start_time);
+
+	k_sem_give(&sem_per_sync);
+}
+
+static void term_cb(struct bt_le_per_adv_sync *sync,
+		    const struct bt_le_per_adv_sync_term_info *info)
+{
+	LOG_INF("Sync terminated (reason %u)", info->reason);
+
+	k_sem_give(&sem_per_sync_lost);
+}
+
+static void recv_cb(struct bt_le_per_adv_sync *sync,
+		    const struct bt_le_per_adv_sync_recv_info *info, struct net_buf_simple *buf)
+{
+	int32_t value = -1;
+
+	if (info->data_status != BT_HCI_LE_ADV_EVT_TYPE_DATA_STATUS_COMPLETE) {
+		return;
+	}
+
+	bt_data_parse(buf, mfg_data_cb, &value);
+
+	/* Periodic data is sent every interval, log only when the counter changes */
+	if (value < 0 || (number_press_valid && value == number_press)) {
+		return;
+	}
+
+	number_press = value;
+	number_press_valid = true;
+	LOG_INF("Button pressed %d times (RSSI %d)", number_press, info->rssi);
+}
+
+static struct bt_le_per_adv_sync_cb sync_callbacks = {
+	.synced = sync_cb,
+	.term = term_cb,
+	.recv = recv_cb,
+};
+
+int main(void)
+{
+	struct bt_le_per_adv_sync_param sync_param;
+	struct bt_le_per_adv_sync *sync;
+	int err;
+
+	LOG_INF("Starting Lesson 2 - Exercise 2 sync observer\n");
+
+	err = dk_leds_init();
+	if (err) {
+		LOG_ERR("LEDs init failed (err %d)\n", err);
+		return -1;
+	}
+
+	err = bt_enable(NULL);
+	if (err) {
+		LOG_ERR("Bluetooth init failed (err %d)\n", err);
+		return -1;
+	}
+
+	LOG_INF("Bluetooth initialized\n");
+
+	bt_le_scan_cb_register(&scan_callbacks);
+	bt_le_per_adv_sync_cb_register(&sync_callbacks);
+
+	for (;;) {
+		/* A report or callback of the previous attempt may have left a count */
+		k_sem_reset(&sem_per_adv);
+		per_adv_found = false;
+		scan_start_time = k_uptime_get();
+
+		err = bt_le_scan_start(BT_LE_SCAN_PASSIVE, NULL);
+		if (err) {
+			LOG_ERR("Scanning failed to start (err %d)\n", err);
+			return -1;
+		}
+
+		LOG_INF("Scanning for %s\n", TARGET_NAME);
+		k_sem_take(&sem_per_adv, K_FOREVER);
+
+		bt_addr_le_copy(&sync_param.addr, &per_addr);
+		sync_param.options = BT_LE_PER_ADV_SYNC_OPT_NONE;
+		sync_param.sid = per_sid;
+		sync_param.skip = 0;
+		/* Supervision timeout of five periodic intervals, in 10 ms units */
+		sync_param.timeout = CLAMP(PER_INTERVAL_TO_MS(per_interval) * 5U / 10U,
+					   BT_GAP_PER_ADV_MIN_TIMEOUT, BT_GAP_PER_ADV_MAX_TIMEOUT);
+
+		k_sem_reset(&sem_per_sync);
+		k_sem_reset(&sem_per_sync_lost);
+		err = bt_le_per_adv_sync_create(&sync_param, &sync);
+		if (err) {
+			LOG_ERR("Failed to create sync (err %d)\n", err);
+			bt_le_scan_stop();
+			continue;
+		}
+
+		if (k_sem_take(&sem_per_sync, SYNC_CREATE_TIMEOUT)) {
+			LOG_WRN("Sync timed out, scanning again\n");
+			bt_le_per_adv_sync_delete(sync);
+			bt_le_scan_stop();
+			continue;
+		}
+
+		/* Once synced, updates arrive at known times and scanning can stop */
+		bt_le_scan_stop();
+		dk_set_led_on(SYNC_STATUS_LED);
+
+		k_sem_take(&sem_per_sync_lost, K_FOREVER);
+		dk_set_led_off(SYNC_STATUS_LED);
+		number_press_valid = false;
+	}
+}
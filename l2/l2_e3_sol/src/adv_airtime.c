@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Advertising on-air time estimation
+ */
+
+#include <zephyr/sys/util.h>
+#include <zephyr/bluetooth/gap.h>
+
+#include "adv_airtime.h"
+
+/* Access address, PDU header and CRC */
+#define PDU_OVERHEAD_LEN (4 + 2 + 3)
+#define PDU_MAX_PAYLOAD_LEN 255
+
+/* AdvA of legacy advertising PDUs */
+#define LEGACY_HDR_LEN 6
+/* Extended header length/AdvMode, flags, ADI and AuxPtr */
+#define ADV_EXT_IND_LEN (1 + 1 + 2 + 3)
+/* Extended header length/AdvMode, flags, AdvA and ADI */
+#define AUX_ADV_IND_HDR_LEN (1 + 1 + 6 + 2)
+/* Extended header length/AdvMode, flags and ADI */
+#define AUX_CHAIN_IND_HDR_LEN (1 + 1 + 2)
+#define AUX_PTR_LEN 3
+
+uint32_t adv_airtime_pdu_us(uint8_t phy, size_t payload_len)
+{
+	switch (phy) {
+	case BT_GAP_LE_PHY_2M:
+		/* 2 byte preamble, 4 us per byte */
+		return (2 + PDU_OVERHEAD_LEN + payload_len) * 4;
+	case BT_GAP_LE_PHY_CODED:
+		/* 80 us preamble, then at S8 256 us access address, 16 us CI and
+		 * 24 us TERM1, 64 us per byte of header, payload and CRC, 24 us TERM2
+		 */
+		return 80 + 256 + 16 + 24 + (2 + payload_len + 3) * 64 + 24;
+	default:
+		/* 1 byte preamble, 8 us per byte */
+		return (1 + PDU_OVERHEAD_LEN + payload_len) * 8;
+	}
+}
+
+uint32_t adv_airtime_legacy_event_us(size_t ad_len)
+{
+	return 3 * adv_airtime_pdu_us(BT_GAP_LE_PHY_1M, LEGACY_HDR_LEN + ad_len);
+}
+
+uint32_t adv_airtime_ext_event_us(uint8_t primary_phy, uint8_t secondary_phy, size_t ad_len)
+{
+	uint32_t time_us = 3 * adv_airtime_pdu_us(primary_phy, ADV_EXT_IND_LEN);
+	size_t hdr_len = AUX_ADV_IND_HDR_LEN;
+
+	do {
+		size_t room = PDU_MAX_PAYLOAD_LEN - hdr_len;
+		size_t chunk = MIN(ad_len, room);
+
+		/* A following AUX_CHAIN_IND needs an AuxPtr in this PDU */
+		if (ad_len > room) {
+			chunk = room - AUX_PTR_LEN;
+			hdr_len += AUX_PTR_LEN;
+		}
+
+		time_us += adv_airtime_pdu_us(secondary_phy, hdr_len + chunk);
+		ad_len -= chunk;
+		hdr_len = AUX_CHAIN_IND_HDR_LEN;
+	} while (ad_len > 0);
+
+	return time_us;
+}
+
+uint32_t adv_airtime_duty(uint32_t event_us, uint32_t interval)
+{
+	/* interval * 625 us, result in units of 0.01 % */
+	return (uint32_t)(((uint64_t)event_us * 10000U) / ((uint64_t)interval * 625U));
+}
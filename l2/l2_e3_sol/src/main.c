@@ -16,6 +16,8 @@
 
 #include <dk_buttons_and_leds.h>
 
+#include "multi_id.h"
+
 /* STEP 5.1 - Create the advertising parameter for connectable advertising */
 static const struct bt_le_adv_param *adv_param = BT_LE_ADV_PARAM(
 	(BT_LE_ADV_OPT_CONN |
@@ -44,10 +46,47 @@ static const struct bt_data sd[] = {
 	BT_DATA_BYTES(BT_DATA_UUID128_ALL,
 		      BT_UUID_128_ENCODE(0x00001523, 0x1212, 0xefde, 0x1523, 0x785feabcd123)),
 };
+
+/* Second logical device on its own identity. The sample has no GATT services of
+ * its own and all identities share one GATT database, so neither device
+ * advertises a service UUID.
+ */
+#define SECOND_DEVICE_NAME "Nordic_Peripheral_2"
+#define SECOND_DEVICE_NAME_LEN (sizeof(SECOND_DEVICE_NAME) - 1)
+
+static const struct bt_data second_ad[] = {
+	BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+	BT_DATA(BT_DATA_NAME_COMPLETE, SECOND_DEVICE_NAME, SECOND_DEVICE_NAME_LEN),
+};
+
+static struct multi_id_dev multi_id_devs[] = {
+	{
+		.name = "First device",
+		.addr = "FF:EE:DD:CC:BB:AA",
+		.ad = ad,
+		.ad_len = ARRAY_SIZE(ad),
+		.interval = 800, /* 500 ms */
+	},
+	{
+		.name = "Second device",
+		.addr = "FF:EE:DD:CC:BB:AB",
+		.ad = second_ad,
+		.ad_len = ARRAY_SIZE(second_ad),
+		.interval = 1600, /* 1 s */
+	},
+};
+
 /* STEP 5.2 - Resume advertising after a disconnection */
 static void adv_work_handler(struct k_work *work)
 {
-	int err = bt_le_adv_start(adv_param, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+	int err;
+
+	if (IS_ENABLED(CONFIG_MULTI_ID)) {
+		multi_id_restart();
+		return;
+	}
+
+	err = bt_le_adv_start(adv_param, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
 
 	if (err) {
 		printk("Advertising failed to start (err %d)\n", err);
@@ -104,7 +143,15 @@ int main(void)
 	LOG_INF("Bluetooth initialized\n");
 	/* STEP 5.3 - Start connectable advertising */
 	k_work_init(&adv_work, adv_work_handler);
-	advertising_start();
+	if (IS_ENABLED(CONFIG_MULTI_ID)) {
+		err = multi_id_start(multi_id_devs, ARRAY_SIZE(multi_id_devs));
+		if (err) {
+			LOG_ERR("Multi-identity advertising failed to start (err %d)\n", err);
+			return -1;
+		}
+	} else {
+		advertising_start();
+	}
 
 	LOG_INF("Advertising successfully started\n");
 
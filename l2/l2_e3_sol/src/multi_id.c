@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Multiple advertising identities
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/addr.h>
+
+#include "multi_id.h"
+#include "adv_airtime.h"
+
+LOG_MODULE_DECLARE(Lesson2_Exercise3);
+
+static struct multi_id_dev *devices;
+static size_t device_count;
+
+struct multi_id_dev *multi_id_from_conn(struct bt_conn *conn)
+{
+	struct bt_conn_info info;
+
+	if (bt_conn_get_info(conn, &info)) {
+		return NULL;
+	}
+
+	for (size_t i = 0; i < device_count; i++) {
+		if (devices[i].id == info.id) {
+			return &devices[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int dev_adv_start(struct multi_id_dev *dev)
+{
+	int err = bt_le_ext_adv_start(dev->adv, BT_LE_EXT_ADV_START_DEFAULT);
+
+	if (err) {
+		LOG_ERR("%s: advertising failed to start (err %d)", dev->name, err);
+		return err;
+	}
+
+	dev->advertising = true;
+	dev->adv_starts++;
+	return 0;
+}
+
+static void on_connected(struct bt_conn *conn, uint8_t err)
+{
+	struct multi_id_dev *dev;
+
+	if (err) {
+		return;
+	}
+
+	dev = multi_id_from_conn(conn);
+	if (!dev) {
+		return;
+	}
+
+	/* The set the central connected to has stopped advertising */
+	dev->advertising = false;
+	dev->conn = bt_conn_ref(conn);
+	dev->connections++;
+	dev->connected_since = k_uptime_get();
+	LOG_INF("%s (identity %u): connected, %u connections so far", dev->name, dev->id,
+		dev->connections);
+}
+
+static void on_disconnected(struct bt_conn *conn, uint8_t reason)
+{
+	for (size_t i = 0; i < device_count; i++) {
+		struct multi_id_dev *dev = &devices[i];
+
+		if (dev->conn != conn) {
+			continue;
+		}
+
+		dev->connected_ms += k_uptime_get() - dev->connected_since;
+		bt_conn_unref(dev->conn);
+		dev->conn = NULL;
+		LOG_INF("%s (identity %u): disconnected (reason %u), %lld ms connected in total, "
+			"%u advertising starts",
+			dev->name, dev->id, reason, dev->connected_ms, dev->adv_starts);
+		return;
+	}
+}
+
+BT_CONN_CB_DEFINE(multi_id_conn_callbacks) = {
+	.connected = on_connected,
+	.disconnected = on_disconnected,
+};
+
+static uint32_t dev_duty(const struct multi_id_dev *dev)
+{
+	size_t ad_len = bt_data_get_len(dev->ad, dev->ad_len);
+
+	return adv_airtime_duty(adv_airtime_legacy_event_us(ad_len), dev->interval);
+}
+
+/* All sets share one radio, the controller schedules their events in turn */
+static void log_airtime(void)
+{
+	uint32_t total = 0;
+
+	for (size_t i = 0; i < device_count; i++) {
+		total += dev_duty(&devices[i]);
+	}
+
+	for (size_t i = 0; i < device_count; i++) {
+		uint32_t duty = dev_duty(&devices[i]);
+
+		LOG_INF("%s (identity %u): %u.%02u %% airtime, %u %% of the advertising airtime",
+			devices[i].name, devices[i].id, duty / 100U, duty % 100U,
+			total ? (duty * 100U) / total : 0);
+	}
+
+	LOG_INF("All identities: %u.%02u %% airtime", total / 100U, total % 100U);
+}
+
+int multi_id_start(struct multi_id_dev *devs, size_t count)
+{
+	int err;
+
+	devices = devs;
+	device_count = count;
+
+	for (size_t i = 0; i < count; i++) {
+		struct multi_id_dev *dev = &devs[i];
+		struct bt_le_adv_param param = BT_LE_ADV_PARAM_INIT(
+			BT_LE_ADV_OPT_CONN | BT_LE_ADV_OPT_USE_IDENTITY, dev->interval,
+			dev->interval + 1, NULL);
+		bt_addr_le_t addr;
+
+		if (i == 0) {
+			dev->id = BT_ID_DEFAULT;
+		} else {
+			err = bt_addr_le_from_str(dev->addr, "random", &addr);
+			if (err) {
+				LOG_ERR("%s: invalid address (err %d)", dev->name, err);
+				return err;
+			}
+
+			err = bt_id_create(&addr, NULL);
+			if (err < 0) {
+				LOG_ERR("%s: creating identity failed (err %d)", dev->name, err);
+				return err;
+			}
+
+			dev->id = err;
+		}
+
+		/* Without BT_LE_ADV_OPT_EXT_ADV the sets send legacy PDUs, so every
+		 * scanner sees them and the scan response data is used.
+		 */
+		param.id = dev->id;
+		err = bt_le_ext_adv_create(&param, NULL, &dev->adv);
+		if (err) {
+			LOG_ERR("%s: failed to create advertising set (err %d)", dev->name, err);
+			return err;
+		}
+
+		err = bt_le_ext_adv_set_data(dev->adv, dev->ad, dev->ad_len, dev->sd, dev->sd_len);
+		if (err) {
+			LOG_ERR("%s: failed to set advertising data (err %d)", dev->name, err);
+			return err;
+		}
+
+		err = dev_adv_start(dev);
+		if (err) {
+			return err;
+		}
+
+		LOG_INF("%s advertising as identity %u", dev->name, dev->id);
+	}
+
+	log_airtime();
+
+	return 0;
+}
+
+void multi_id_restart(void)
+{
+	for (size_t i = 0; i < device_count; i++) {
+		if (!devices[i].advertising && !devices[i].conn) {
+			dev_adv_start(&devices[i]);
+		}
+	}
+}
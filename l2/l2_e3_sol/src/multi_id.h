@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MULTI_ID_H_
+#define MULTI_ID_H_
+
+/**@file
+ * @defgroup multi_id Multiple advertising identities
+ * @{
+ * @brief Present several logical devices from one radio.
+ *
+ * Each logical device gets its own identity address from bt_id_create() and
+ * its own connectable advertising set with separate advertising and scan
+ * response data. Connections are attributed to the logical device through
+ * the local identity they were made on. All identities share the GATT
+ * database, so this selects per-device state, not the services a central
+ * sees.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+
+/** @brief A logical device. */
+struct multi_id_dev {
+	/** Name used in the log. */
+	const char *name;
+	/** Random static identity address, as a string. */
+	const char *addr;
+	/** Advertising data. */
+	const struct bt_data *ad;
+	size_t ad_len;
+	/** Scan response data. Can be NULL. */
+	const struct bt_data *sd;
+	size_t sd_len;
+	/** Advertising interval in 0.625 ms units. */
+	uint16_t interval;
+
+	/* Internal state, set by the module */
+	uint8_t id;
+	struct bt_le_ext_adv *adv;
+	bool advertising;
+	struct bt_conn *conn;
+	int64_t connected_since;
+	/* Per-identity statistics */
+	uint32_t connections;
+	uint32_t adv_starts;
+	int64_t connected_ms;
+};
+
+/** @brief Create the identities and advertising sets and start advertising.
+ *
+ * The first device reuses the default identity, which must already have been
+ * created with its address before bt_enable().
+ *
+ * @param[in] devs Logical devices. Must stay valid.
+ * @param[in] count Number of elements in @p devs.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int multi_id_start(struct multi_id_dev *devs, size_t count);
+
+/** @brief Restart the advertising sets of devices that are not connected. */
+void multi_id_restart(void);
+
+/** @brief Logical device a connection was made to.
+ *
+ * @param[in] conn Connection object.
+ *
+ * @return The device, or NULL if the connection is on an unknown identity.
+ */
+struct multi_id_dev *multi_id_from_conn(struct bt_conn *conn);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* MULTI_ID_H_ */
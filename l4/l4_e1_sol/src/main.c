@@ -94,6 +94,7 @@ static void button_changed(uint32_t button_state, uint32_t has_changed)
 	if (has_changed & USER_BUTTON) {
 		uint32_t user_button_state = button_state & USER_BUTTON;
 		app_button_state = user_button_state ? true : false;
+		my_lbs_set_button_state(app_button_state);
 	}
 }
 static void on_connected(struct bt_conn *conn, uint8_t err)
@@ -44,7 +44,7 @@ typedef bool (*button_cb_t)(void);
 struct my_lbs_cb {
 	/** LED state change callback. */
 	led_cb_t led_cb;
-	/** Button read callback. */
+	/** Button state callback, called once at init to seed the cached value. */
 	button_cb_t button_cb;
 };
 
@@ -63,6 +63,15 @@ struct my_lbs_cb {
  */
 int my_lbs_init(struct my_lbs_cb *callbacks);
 
+/** @brief Update the cached button state.
+ *
+ * The Button characteristic is read from this cache, so the application
+ * must call this function whenever the button changes state.
+ *
+ * @param[in] button_state_new The new state of the button.
+ */
+void my_lbs_set_button_state(bool button_state_new);
+
 #ifdef __cplusplus
 }
 #endif
@@ -99,6 +99,7 @@ static void button_changed(uint32_t button_state, uint32_t has_changed)
 		/* STEP 6 - Send indication on a button press */
 
 		app_button_state = user_button_state ? true : false;
+		my_lbs_set_button_state(app_button_state);
 	}
 }
 static void on_connected(struct bt_conn *conn, uint8_t err)
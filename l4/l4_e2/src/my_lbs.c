@@ -28,7 +28,8 @@ LOG_MODULE_DECLARE(Lesson4_Exercise2);
 
 static bool notify_mysensor_enabled;
 static bool indicate_enabled;
-static bool button_state;
+/* Cached Button characteristic value, refreshed by my_lbs_set_button_state() */
+static atomic_t button_state;
 static struct my_lbs_cb lbs_cb;
 
 /* STEP 4 - Define an indication parameter */
@@ -77,18 +78,14 @@ static ssize_t write_led(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 static ssize_t read_button(struct bt_conn *conn, const struct bt_gatt_attr *attr, void *buf,
 			   uint16_t len, uint16_t offset)
 {
-	// get a pointer to button_state which is passed in the BT_GATT_CHARACTERISTIC() and stored in attr->user_data
-	const char *value = attr->user_data;
+	/* Serve the cached value so that reads never call into the application and
+	 * concurrent reads from several connections do not race.
+	 */
+	const uint8_t value = atomic_get(&button_state) ? 1U : 0U;
 
 	LOG_DBG("Attribute read, handle: %u, conn: %p", attr->handle, (void *)conn);
 
-	if (lbs_cb.button_cb) {
-		// Call the application callback function to update the get the current value of the button
-		button_state = lbs_cb.button_cb();
-		return bt_gatt_attr_read(conn, attr, buf, len, offset, value, sizeof(*value));
-	}
-
-	return 0;
+	return bt_gatt_attr_read(conn, attr, buf, len, offset, &value, sizeof(value));
 }
 
 /* LED Button Service Declaration */
@@ -96,7 +93,7 @@ BT_GATT_SERVICE_DEFINE(
 	my_lbs_svc, BT_GATT_PRIMARY_SERVICE(BT_UUID_LBS),
 	/* STEP 1 - Modify the Button characteristic declaration to support indication */
 	BT_GATT_CHARACTERISTIC(BT_UUID_LBS_BUTTON, BT_GATT_CHRC_READ, BT_GATT_PERM_READ,
-			       read_button, NULL, &button_state),
+			       read_button, NULL, NULL),
 	/* STEP 2 - Create and add the Client Characteristic Configuration Descriptor */
 
 	BT_GATT_CHARACTERISTIC(BT_UUID_LBS_LED, BT_GATT_CHRC_WRITE, BT_GATT_PERM_WRITE, NULL,
@@ -110,11 +107,20 @@ int my_lbs_init(struct my_lbs_cb *callbacks)
 	if (callbacks) {
 		lbs_cb.led_cb = callbacks->led_cb;
 		lbs_cb.button_cb = callbacks->button_cb;
+
+		if (lbs_cb.button_cb) {
+			my_lbs_set_button_state(lbs_cb.button_cb());
+		}
 	}
 
 	return 0;
 }
 
+void my_lbs_set_button_state(bool button_state_new)
+{
+	atomic_set(&button_state, button_state_new ? 1 : 0);
+}
+
 /* STEP 5.1 - Define the function to send indications */
 
 /* STEP 14 - Define the function to send notifications for the MYSENSOR characteristic */
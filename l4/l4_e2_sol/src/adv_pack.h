@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef ADV_PACK_H_
+#define ADV_PACK_H_
+
+/**@file
+ * @defgroup adv_pack Advertising payload packing
+ * @{
+ * @brief Build-time helpers that fit the device name into what is left of a
+ * legacy advertising packet.
+ *
+ * A central that filters on a service UUID can only match and connect once it
+ * has seen the UUID. Placing it in the advertising packet rather than the
+ * scan response saves the scan request and response round trip. What room is
+ * left is used for the device name, shortened if needed.
+ *
+ * All macros are integer constant expressions and can be used in @c #if
+ * directives as long as their arguments can.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr/sys/util.h>
+#include <zephyr/bluetooth/gap.h>
+
+/** @brief Encoded size of an AD structure with @p _data_len bytes of data. */
+#define ADV_PACK_AD_SIZE(_data_len) (2 + (_data_len))
+
+/** @brief Room for name characters once @p _used bytes of the packet are taken. */
+#define ADV_PACK_NAME_ROOM(_used)                                                                  \
+	(((_used) + ADV_PACK_AD_SIZE(0) < BT_GAP_ADV_MAX_ADV_DATA_LEN)                             \
+		 ? (BT_GAP_ADV_MAX_ADV_DATA_LEN - (_used) - ADV_PACK_AD_SIZE(0))                   \
+		 : 0)
+
+/** @brief Number of name characters to advertise. */
+#define ADV_PACK_NAME_LEN(_name_len, _used) MIN((_name_len), ADV_PACK_NAME_ROOM(_used))
+
+/** @brief AD type of the advertised name, complete or shortened. */
+#define ADV_PACK_NAME_TYPE(_name_len, _used)                                                       \
+	(((_name_len) > ADV_PACK_NAME_ROOM(_used)) ? BT_DATA_NAME_SHORTENED                        \
+						   : BT_DATA_NAME_COMPLETE)
+
+/** @brief Whether at least @p _min_name_len name characters fit. */
+#define ADV_PACK_FITS(_used, _min_name_len) (ADV_PACK_NAME_ROOM(_used) >= (_min_name_len))
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ADV_PACK_H_ */
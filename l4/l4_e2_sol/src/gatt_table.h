@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef GATT_TABLE_H_
+#define GATT_TABLE_H_
+
+/**@file
+ * @defgroup gatt_table Declarative GATT service table
+ * @{
+ * @brief Macros that build a GATT service from a single attribute table.
+ *
+ * A service is described once as an X-macro table taking three entry macros:
+ *
+ * - SVC(name, uuid) for the primary service declaration,
+ * - CHRC(name, uuid, props, perm, read, write, user_data) for a characteristic,
+ * - CCC(name, changed, perm) for a Client Characteristic Configuration Descriptor.
+ *
+ * From that table the macros below emit an enum of attribute indices, the
+ * BT_GATT_SERVICE_DEFINE() itself and constant attribute pointers, so the
+ * send path never depends on hand-counted indices into the attribute array.
+ * A characteristic occupies two attributes: @c name_DECL for its declaration
+ * and @c name for its value, which is the one to notify or indicate on.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr/sys/util.h>
+#include <zephyr/bluetooth/gatt.h>
+
+#define GATT_TABLE_ENUM_SVC(_name, _uuid) _name,
+#define GATT_TABLE_ENUM_CHRC(_name, ...) _name##_DECL, _name,
+#define GATT_TABLE_ENUM_CCC(_name, ...) _name,
+
+#define GATT_TABLE_ATTR_SVC(_name, _uuid) BT_GATT_PRIMARY_SERVICE(_uuid),
+#define GATT_TABLE_ATTR_CHRC(_name, _uuid, _props, _perm, _read, _write, _user_data)               \
+	BT_GATT_CHARACTERISTIC(_uuid, _props, _perm, _read, _write, _user_data),
+#define GATT_TABLE_ATTR_CCC(_name, _changed, _perm) BT_GATT_CCC(_changed, _perm),
+
+/** @brief Declare the attribute index enum of a service table.
+ *
+ * @param _table X-macro describing the service.
+ * @param _count Name of the enumerator holding the number of attributes.
+ */
+#define GATT_TABLE_ENUM(_table, _count)                                                            \
+	enum {                                                                                     \
+		_table(GATT_TABLE_ENUM_SVC, GATT_TABLE_ENUM_CHRC, GATT_TABLE_ENUM_CCC) _count      \
+	}
+
+/** @brief Define a static GATT service from a service table.
+ *
+ * The attribute count of the generated service is checked against the
+ * index enum at build time.
+ *
+ * @param _svc   Name of the service, as for BT_GATT_SERVICE_DEFINE().
+ * @param _table X-macro describing the service.
+ * @param _count Enumerator declared by GATT_TABLE_ENUM().
+ */
+#define GATT_TABLE_SERVICE_DEFINE(_svc, _table, _count)                                            \
+	BT_GATT_SERVICE_DEFINE(_svc, _table(GATT_TABLE_ATTR_SVC, GATT_TABLE_ATTR_CHRC,            \
+					    GATT_TABLE_ATTR_CCC));                                 \
+	BUILD_ASSERT(ARRAY_SIZE(attr_##_svc) == (_count),                                          \
+		     "GATT table and service attribute count differ")
+
+/** @brief Constant pointer to an attribute of a table-defined service. */
+#define GATT_TABLE_ATTR(_svc, _name) (&attr_##_svc[_name])
+
+/** @brief Define a typed helper that notifies a characteristic value.
+ *
+ * The generated function has the signature
+ * @code int _fn(struct bt_conn *conn, const _type *value) @endcode
+ */
+#define GATT_TABLE_NOTIFY_DEFINE(_fn, _svc, _name, _type)                                          \
+	static int _fn(struct bt_conn *conn, const _type *value)                                   \
+	{                                                                                          \
+		return bt_gatt_notify(conn, GATT_TABLE_ATTR(_svc, _name), value, sizeof(*value));   \
+	}
+
+/** @brief Define a typed helper that indicates a characteristic value.
+ *
+ * The generated function has the signature
+ * @code int _fn(struct bt_conn *conn, struct bt_gatt_indicate_params *params,
+ *               const _type *value) @endcode
+ * and fills in @p params, which must stay valid until @p _func is called.
+ */
+#define GATT_TABLE_INDICATE_DEFINE(_fn, _svc, _name, _type, _func)                                 \
+	static int _fn(struct bt_conn *conn, struct bt_gatt_indicate_params *params,              \
+		       const _type *value)                                                         \
+	{                                                                                          \
+		params->attr = GATT_TABLE_ATTR(_svc, _name);                                       \
+		params->func = _func;                                                              \
+		params->destroy = NULL;                                                            \
+		params->data = value;                                                              \
+		params->len = sizeof(*value);                                                      \
+		return bt_gatt_indicate(conn, params);                                             \
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* GATT_TABLE_H_ */
@@ -12,6 +12,8 @@
 #include <zephyr/bluetooth/conn.h>
 #include <dk_buttons_and_leds.h>
 #include "my_lbs.h"
+#include "sensor_codec.h"
+#include "adv_pack.h"
 
 static const struct bt_le_adv_param *adv_param = BT_LE_ADV_PARAM(
 	(BT_LE_ADV_OPT_CONN |
@@ -41,6 +43,39 @@ static struct k_work adv_work;
 /* STEP 15 - Define the data you want to stream over Bluetooth LE */
 static uint32_t app_sensor_value = 100;
 
+/* Batch of encoded samples and running totals for the bytes-per-sample metric */
+static uint8_t sensor_batch[CONFIG_MY_LBS_SENSOR_BATCH_LEN];
+static struct sensor_codec sensor_codec;
+static uint32_t sensor_samples_sent;
+static uint32_t sensor_bytes_sent;
+
+/* Flags and the 128-bit service UUID, the name goes into the remaining room */
+#define ADV_PACKED_USED (ADV_PACK_AD_SIZE(1) + ADV_PACK_AD_SIZE(BT_UUID_SIZE_128))
+
+#if defined(CONFIG_MY_LBS_ADV_PACKED)
+#if ADV_PACK_FITS(ADV_PACKED_USED, CONFIG_MY_LBS_ADV_PACKED_MIN_NAME_LEN)
+#define ADV_PACKED 1
+#else
+#warning "Service UUID and name do not fit the advertising packet, UUID is in the scan response"
+#define ADV_PACKED 0
+#endif
+#else
+#define ADV_PACKED 0
+#endif
+
+#if ADV_PACKED
+static const struct bt_data ad[] = {
+	BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+	BT_DATA_BYTES(BT_DATA_UUID128_ALL, BT_UUID_LBS_VAL),
+	BT_DATA(ADV_PACK_NAME_TYPE(DEVICE_NAME_LEN, ADV_PACKED_USED), DEVICE_NAME,
+		ADV_PACK_NAME_LEN(DEVICE_NAME_LEN, ADV_PACKED_USED)),
+};
+
+/* Active scanners still get the complete name */
+static const struct bt_data sd[] = {
+	BT_DATA(BT_DATA_NAME_COMPLETE, DEVICE_NAME, DEVICE_NAME_LEN),
+};
+#else
 static const struct bt_data ad[] = {
 	BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
 	BT_DATA(BT_DATA_NAME_COMPLETE, DEVICE_NAME, DEVICE_NAME_LEN),
@@ -50,6 +85,18 @@ static const struct bt_data ad[] = {
 static const struct bt_data sd[] = {
 	BT_DATA_BYTES(BT_DATA_UUID128_ALL, BT_UUID_LBS_VAL),
 };
+#endif
+
+/* Time advertising was (re)started, to measure how long a central needs to connect */
+static int64_t adv_start_time;
+/* Time of the last disconnection, to measure how long until we advertise again */
+static int64_t disconnect_time;
+
+#if defined(CONFIG_MY_LBS_ADV_WORKQ)
+/* Restarting advertising does not wait behind other system workqueue items */
+static K_THREAD_STACK_DEFINE(adv_workq_stack, CONFIG_MY_LBS_ADV_WORKQ_STACK_SIZE);
+static struct k_work_q adv_workq;
+#endif
 
 static void adv_work_handler(struct k_work *work)
 {
@@ -60,11 +107,22 @@ static void adv_work_handler(struct k_work *work)
 		return;
 	}
 
+	adv_start_time = k_uptime_get();
 	printk("Advertising successfully started\n");
+
+	if (disconnect_time) {
+		LOG_INF("Advertising again %lld ms after disconnection",
+			adv_start_time - disconnect_time);
+		disconnect_time = 0;
+	}
 }
 static void advertising_start(void)
 {
+#if defined(CONFIG_MY_LBS_ADV_WORKQ)
+	k_work_submit_to_queue(&adv_workq, &adv_work);
+#else
 	k_work_submit(&adv_work);
+#endif
 }
 static void recycled_cb(void)
 {
@@ -89,14 +147,51 @@ static bool app_button_cb(void)
 	return app_button_state;
 }
 
+static void app_config_cb(const uint8_t *data, uint16_t len)
+{
+	LOG_INF("Configuration received (%u bytes)", len);
+}
+
+static void send_sensor_batch(void)
+{
+	uint8_t count = sensor_codec_count(&sensor_codec);
+
+	if (count && !my_lbs_send_sensor_batch_notify(sensor_batch, sensor_codec.len)) {
+		sensor_samples_sent += count;
+		sensor_bytes_sent += sensor_codec.len;
+
+		uint32_t centi = (sensor_bytes_sent * 100U) / sensor_samples_sent;
+
+		LOG_INF("Sensor batch: %u samples in %zu bytes, %u.%02u bytes/sample on average",
+			count, sensor_codec.len, centi / 100U, centi % 100U);
+	}
+
+	sensor_codec_init(&sensor_codec, sensor_batch, sizeof(sensor_batch));
+}
+
+static void add_sensor_sample(uint32_t value)
+{
+	/* A full batch is sent and the sample starts the next one as its keyframe */
+	if (sensor_codec_add(&sensor_codec, value)) {
+		send_sensor_batch();
+		sensor_codec_add(&sensor_codec, value);
+	}
+}
+
 /* STEP 18.1 - Define the thread function  */
 void send_data_thread(void)
 {
+	sensor_codec_init(&sensor_codec, sensor_batch, sizeof(sensor_batch));
+
 	while (1) {
 		/* Simulate data */
 		simulate_data();
 		/* Send notification, the function sends notifications only if a client is subscribed */
-		my_lbs_send_sensor_notify(app_sensor_value);
+		if (IS_ENABLED(CONFIG_MY_LBS_SENSOR_COMPACT)) {
+			add_sensor_sample(app_sensor_value);
+		} else {
+			my_lbs_send_sensor_notify(app_sensor_value);
+		}
 
 		k_sleep(K_MSEC(NOTIFY_INTERVAL));
 	}
@@ -105,6 +200,7 @@ void send_data_thread(void)
 static struct my_lbs_cb app_callbacks = {
 	.led_cb = app_led_cb,
 	.button_cb = app_button_cb,
+	.config_cb = app_config_cb,
 };
 
 static void button_changed(uint32_t button_state, uint32_t has_changed)
@@ -114,6 +210,7 @@ static void button_changed(uint32_t button_state, uint32_t has_changed)
 		/* STEP 6 - Send indication on a button press */
 		my_lbs_send_button_state_indicate(user_button_state);
 		app_button_state = user_button_state ? true : false;
+		my_lbs_set_button_state(app_button_state);
 	}
 }
 static void on_connected(struct bt_conn *conn, uint8_t err)
@@ -124,6 +221,9 @@ static void on_connected(struct bt_conn *conn, uint8_t err)
 	}
 
 	printk("Connected\n");
+	LOG_INF("Connected %lld ms after advertising start, UUID in the %s",
+		k_uptime_get() - adv_start_time,
+		ADV_PACKED ? "advertising packet" : "scan response");
 
 	dk_set_led_on(CON_STATUS_LED);
 }
@@ -131,6 +231,7 @@ static void on_connected(struct bt_conn *conn, uint8_t err)
 static void on_disconnected(struct bt_conn *conn, uint8_t reason)
 {
 	printk("Disconnected (reason %u)\n", reason);
+	disconnect_time = k_uptime_get();
 
 	dk_set_led_off(CON_STATUS_LED);
 }
@@ -186,6 +287,11 @@ int main(void)
 	}
 	LOG_INF("Bluetooth initialized\n");
 	k_work_init(&adv_work, adv_work_handler);
+#if defined(CONFIG_MY_LBS_ADV_WORKQ)
+	k_work_queue_start(&adv_workq, adv_workq_stack, K_THREAD_STACK_SIZEOF(adv_workq_stack),
+			   CONFIG_MY_LBS_ADV_WORKQ_PRIORITY, NULL);
+	k_thread_name_set(&adv_workq.thread, "adv_workq");
+#endif
 	advertising_start();
 	for (;;) {
 		dk_set_led(RUN_STATUS_LED, (++blink_status) % 2);
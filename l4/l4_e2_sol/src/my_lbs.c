@@ -23,14 +23,21 @@
 #include <zephyr/bluetooth/gatt.h>
 
 #include "my_lbs.h"
+#include "gatt_table.h"
 
 LOG_MODULE_DECLARE(Lesson4_Exercise2);
 
 static bool notify_mysensor_enabled;
 static bool indicate_enabled;
-static bool button_state;
+/* Cached Button characteristic value, refreshed by my_lbs_set_button_state() */
+static atomic_t button_state;
 static struct my_lbs_cb lbs_cb;
 
+/* Reassembly state of the bulk configuration characteristic */
+static uint8_t config_buf[MY_LBS_CONFIG_MAX_LEN];
+static uint16_t config_len;
+static int64_t config_start_time;
+
 /* STEP 4 - Define an indication parameter */
 static struct bt_gatt_indicate_params ind_params;
 
@@ -82,64 +89,162 @@ static ssize_t write_led(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 	return len;
 }
 
+static void config_reset(void)
+{
+	config_len = 0;
+	config_start_time = 0;
+}
+
+static void config_commit(void)
+{
+	int64_t elapsed = config_start_time ? k_uptime_get() - config_start_time : 0;
+	uint32_t rate = elapsed > 0 ? (uint32_t)((config_len * 1000LL) / elapsed) : 0;
+
+	LOG_INF("Config committed: %u bytes in %lld ms (%u bytes/s)", config_len, elapsed, rate);
+
+	if (lbs_cb.config_cb) {
+		lbs_cb.config_cb(config_buf, config_len);
+	}
+
+	config_reset();
+}
+
+static ssize_t write_config(struct bt_conn *conn, const struct bt_gatt_attr *attr, const void *buf,
+			    uint16_t len, uint16_t offset, uint8_t flags)
+{
+	/* Write Without Response carries no offset, so those chunks are appended */
+	uint16_t pos = (flags & BT_GATT_WRITE_FLAG_CMD) ? config_len : offset;
+
+	LOG_DBG("Attribute write, handle: %u, conn: %p, offset: %u, len: %u", attr->handle,
+		(void *)conn, pos, len);
+
+	if ((pos + len) > sizeof(config_buf)) {
+		LOG_DBG("Write config: Data exceeds buffer");
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+	}
+
+	if (config_start_time == 0) {
+		config_start_time = k_uptime_get();
+	}
+
+	/* Prepared writes are only validated here, the data follows on execute */
+	if (flags & BT_GATT_WRITE_FLAG_PREPARE) {
+		return 0;
+	}
+
+	if (pos > config_len) {
+		LOG_DBG("Write config: Incorrect data offset");
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+	}
+
+	memcpy(&config_buf[pos], buf, len);
+	config_len = MAX(config_len, pos + len);
+
+	return len;
+}
+
+static ssize_t write_config_ctrl(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+				 const void *buf, uint16_t len, uint16_t offset, uint8_t flags)
+{
+	LOG_DBG("Attribute write, handle: %u, conn: %p", attr->handle, (void *)conn);
+
+	if (len != 1U) {
+		LOG_DBG("Write config ctrl: Incorrect data length");
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+	}
+
+	if (offset != 0) {
+		LOG_DBG("Write config ctrl: Incorrect data offset");
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+	}
+
+	switch (*((uint8_t *)buf)) {
+	case MY_LBS_CONFIG_CTRL_RESET:
+		config_reset();
+		break;
+	case MY_LBS_CONFIG_CTRL_COMMIT:
+		config_commit();
+		break;
+	default:
+		LOG_DBG("Write config ctrl: Incorrect value");
+		return BT_GATT_ERR(BT_ATT_ERR_VALUE_NOT_ALLOWED);
+	}
+
+	return len;
+}
+
 static ssize_t read_button(struct bt_conn *conn, const struct bt_gatt_attr *attr, void *buf,
 			   uint16_t len, uint16_t offset)
 {
-	// get a pointer to button_state which is passed in the BT_GATT_CHARACTERISTIC() and stored in attr->user_data
-	const char *value = attr->user_data;
+	/* Serve the cached value so that reads never call into the application and
+	 * concurrent reads from several connections do not race.
+	 */
+	const uint8_t value = atomic_get(&button_state) ? 1U : 0U;
 
 	LOG_DBG("Attribute read, handle: %u, conn: %p", attr->handle, (void *)conn);
 
-	if (lbs_cb.button_cb) {
-		// Call the application callback function to update the get the current value of the button
-		button_state = lbs_cb.button_cb();
-		return bt_gatt_attr_read(conn, attr, buf, len, offset, value, sizeof(*value));
-	}
-
-	return 0;
+	return bt_gatt_attr_read(conn, attr, buf, len, offset, &value, sizeof(value));
 }
 
 /* LED Button Service Declaration */
-BT_GATT_SERVICE_DEFINE(
-	my_lbs_svc, BT_GATT_PRIMARY_SERVICE(BT_UUID_LBS),
-	/* STEP 1 - Modify the Button characteristic declaration to support indication */
-	BT_GATT_CHARACTERISTIC(BT_UUID_LBS_BUTTON, BT_GATT_CHRC_READ | BT_GATT_CHRC_INDICATE,
-			       BT_GATT_PERM_READ, read_button, NULL, &button_state),
-	/* STEP 2 - Create and add the Client Characteristic Configuration Descriptor */
-	BT_GATT_CCC(mylbsbc_ccc_cfg_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
-
-	BT_GATT_CHARACTERISTIC(BT_UUID_LBS_LED, BT_GATT_CHRC_WRITE, BT_GATT_PERM_WRITE, NULL,
-			       write_led, NULL),
-	/* STEP 12 - Create and add the MYSENSOR characteristic and its CCCD  */
-	BT_GATT_CHARACTERISTIC(BT_UUID_LBS_MYSENSOR, BT_GATT_CHRC_NOTIFY, BT_GATT_PERM_NONE, NULL,
-			       NULL, NULL),
-
-	BT_GATT_CCC(mylbsbc_ccc_mysensor_cfg_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
-
-);
+#define MY_LBS_SVC_TABLE(SVC, CHRC, CCC)                                                           \
+	SVC(MY_LBS_ATTR_SVC, BT_UUID_LBS)                                                          \
+	/* STEP 1 - Modify the Button characteristic declaration to support indication */          \
+	CHRC(MY_LBS_ATTR_BUTTON, BT_UUID_LBS_BUTTON, BT_GATT_CHRC_READ | BT_GATT_CHRC_INDICATE,    \
+	     BT_GATT_PERM_READ, read_button, NULL, NULL)                                           \
+	/* STEP 2 - Create and add the Client Characteristic Configuration Descriptor */           \
+	CCC(MY_LBS_ATTR_BUTTON_CCC, mylbsbc_ccc_cfg_changed,                                       \
+	    BT_GATT_PERM_READ | BT_GATT_PERM_WRITE)                                                \
+	CHRC(MY_LBS_ATTR_LED, BT_UUID_LBS_LED, BT_GATT_CHRC_WRITE, BT_GATT_PERM_WRITE, NULL,       \
+	     write_led, NULL)                                                                      \
+	/* STEP 12 - Create and add the MYSENSOR characteristic and its CCCD  */                   \
+	CHRC(MY_LBS_ATTR_MYSENSOR, BT_UUID_LBS_MYSENSOR, BT_GATT_CHRC_NOTIFY, BT_GATT_PERM_NONE,   \
+	     NULL, NULL, NULL)                                                                     \
+	CCC(MY_LBS_ATTR_MYSENSOR_CCC, mylbsbc_ccc_mysensor_cfg_changed,                            \
+	    BT_GATT_PERM_READ | BT_GATT_PERM_WRITE)                                                \
+	/* Bulk configuration: Write Without Response appends, long writes land at their offset */ \
+	CHRC(MY_LBS_ATTR_CONFIG, BT_UUID_LBS_CONFIG,                                               \
+	     BT_GATT_CHRC_WRITE | BT_GATT_CHRC_WRITE_WITHOUT_RESP,                                 \
+	     BT_GATT_PERM_WRITE | BT_GATT_PERM_PREPARE_WRITE, NULL, write_config, NULL)            \
+	CHRC(MY_LBS_ATTR_CONFIG_CTRL, BT_UUID_LBS_CONFIG_CTRL, BT_GATT_CHRC_WRITE,                 \
+	     BT_GATT_PERM_WRITE, NULL, write_config_ctrl, NULL)
+
+GATT_TABLE_ENUM(MY_LBS_SVC_TABLE, MY_LBS_ATTR_COUNT);
+GATT_TABLE_SERVICE_DEFINE(my_lbs_svc, MY_LBS_SVC_TABLE, MY_LBS_ATTR_COUNT);
+
+/* Typed send helpers bound to the attributes resolved above */
+GATT_TABLE_INDICATE_DEFINE(button_indicate, my_lbs_svc, MY_LBS_ATTR_BUTTON, bool, indicate_cb)
+GATT_TABLE_NOTIFY_DEFINE(mysensor_notify, my_lbs_svc, MY_LBS_ATTR_MYSENSOR, uint32_t)
+
 /* A function to register application callbacks for the LED and Button characteristics  */
 int my_lbs_init(struct my_lbs_cb *callbacks)
 {
 	if (callbacks) {
 		lbs_cb.led_cb = callbacks->led_cb;
 		lbs_cb.button_cb = callbacks->button_cb;
+		lbs_cb.config_cb = callbacks->config_cb;
+
+		if (lbs_cb.button_cb) {
+			my_lbs_set_button_state(lbs_cb.button_cb());
+		}
 	}
 
 	return 0;
 }
 
+void my_lbs_set_button_state(bool button_state_new)
+{
+	atomic_set(&button_state, button_state_new ? 1 : 0);
+}
+
 /* STEP 5 - Define the function to send indications */
 int my_lbs_send_button_state_indicate(bool button_state)
 {
 	if (!indicate_enabled) {
 		return -EACCES;
 	}
-	ind_params.attr = &my_lbs_svc.attrs[2];
-	ind_params.func = indicate_cb; // A remote device has ACKed at its host layer (ATT ACK)
-	ind_params.destroy = NULL;
-	ind_params.data = &button_state;
-	ind_params.len = sizeof(button_state);
-	return bt_gatt_indicate(NULL, &ind_params);
+	// indicate_cb is called when a remote device has ACKed at its host layer (ATT ACK)
+	return button_indicate(NULL, &ind_params, &button_state);
 }
 
 /* STEP 14 - Define the function to send notifications for the MYSENSOR characteristic */
@@ -149,5 +254,14 @@ int my_lbs_send_sensor_notify(uint32_t sensor_value)
 		return -EACCES;
 	}
 
-	return bt_gatt_notify(NULL, &my_lbs_svc.attrs[7], &sensor_value, sizeof(sensor_value));
+	return mysensor_notify(NULL, &sensor_value);
+}
+
+int my_lbs_send_sensor_batch_notify(const uint8_t *data, uint16_t len)
+{
+	if (!notify_mysensor_enabled) {
+		return -EACCES;
+	}
+
+	return bt_gatt_notify(NULL, GATT_TABLE_ATTR(my_lbs_svc, MY_LBS_ATTR_MYSENSOR), data, len);
 }
@@ -34,11 +34,28 @@ extern "C" {
 #define BT_UUID_LBS_MYSENSOR_VAL                                                                   \
 	BT_UUID_128_ENCODE(0x00001526, 0x1212, 0xefde, 0x1523, 0x785feabcd123)
 
+/** @brief Bulk configuration Characteristic UUID. */
+#define BT_UUID_LBS_CONFIG_VAL                                                                     \
+	BT_UUID_128_ENCODE(0x00001527, 0x1212, 0xefde, 0x1523, 0x785feabcd123)
+
+/** @brief Bulk configuration control Characteristic UUID. */
+#define BT_UUID_LBS_CONFIG_CTRL_VAL                                                                \
+	BT_UUID_128_ENCODE(0x00001528, 0x1212, 0xefde, 0x1523, 0x785feabcd123)
+
 #define BT_UUID_LBS BT_UUID_DECLARE_128(BT_UUID_LBS_VAL)
 #define BT_UUID_LBS_BUTTON BT_UUID_DECLARE_128(BT_UUID_LBS_BUTTON_VAL)
 #define BT_UUID_LBS_LED BT_UUID_DECLARE_128(BT_UUID_LBS_LED_VAL)
 /* STEP 11.2 - Convert the array to a generic UUID */
 #define BT_UUID_LBS_MYSENSOR BT_UUID_DECLARE_128(BT_UUID_LBS_MYSENSOR_VAL)
+#define BT_UUID_LBS_CONFIG BT_UUID_DECLARE_128(BT_UUID_LBS_CONFIG_VAL)
+#define BT_UUID_LBS_CONFIG_CTRL BT_UUID_DECLARE_128(BT_UUID_LBS_CONFIG_CTRL_VAL)
+
+/** @brief Size of the reassembly buffer for the bulk configuration characteristic. */
+#define MY_LBS_CONFIG_MAX_LEN 4096
+
+/** @brief Control commands accepted by the configuration control characteristic. */
+#define MY_LBS_CONFIG_CTRL_RESET 0x00
+#define MY_LBS_CONFIG_CTRL_COMMIT 0x01
 
 /** @brief Callback type for when an LED state change is received. */
 typedef void (*led_cb_t)(const bool led_state);
@@ -46,12 +63,17 @@ typedef void (*led_cb_t)(const bool led_state);
 /** @brief Callback type for when the button state is pulled. */
 typedef bool (*button_cb_t)(void);
 
+/** @brief Callback type for when a complete configuration blob is committed. */
+typedef void (*config_cb_t)(const uint8_t *data, uint16_t len);
+
 /** @brief Callback struct used by the LBS Service. */
 struct my_lbs_cb {
 	/** LED state change callback. */
 	led_cb_t led_cb;
-	/** Button read callback. */
+	/** Button state callback, called once at init to seed the cached value. */
 	button_cb_t button_cb;
+	/** Configuration commit callback. */
+	config_cb_t config_cb;
 };
 
 /** @brief Initialize the LBS Service.
@@ -69,6 +91,15 @@ struct my_lbs_cb {
  */
 int my_lbs_init(struct my_lbs_cb *callbacks);
 
+/** @brief Update the cached button state.
+ *
+ * The Button characteristic is read from this cache, so the application
+ * must call this function whenever the button changes state.
+ *
+ * @param[in] button_state_new The new state of the button.
+ */
+void my_lbs_set_button_state(bool button_state_new);
+
 /** @brief Send the button state as indication.
  *
  * This function sends a binary state, typically the state of a
@@ -105,6 +136,19 @@ int my_lbs_send_button_state_notify(bool button_state);
  */
 int my_lbs_send_sensor_notify(uint32_t sensor_value);
 
+/** @brief Send an encoded batch of sensor values as notification.
+ *
+ * This function sends a batch built with the sensor codec, see
+ * sensor_codec.h, to all connected peers.
+ *
+ * @param[in] data Encoded batch.
+ * @param[in] len Length of the encoded batch.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int my_lbs_send_sensor_batch_notify(const uint8_t *data, uint16_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Compact sensor sample encoding
+ */
+
+#include <errno.h>
+
+#include "sensor_codec.h"
+
+static size_t varint_put(uint8_t *buf, uint32_t value)
+{
+	size_t len = 0;
+
+	while (value >= 0x80) {
+		buf[len++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	buf[len++] = (uint8_t)value;
+
+	return len;
+}
+
+static int varint_get(const uint8_t *buf, size_t len, size_t *pos, uint32_t *value)
+{
+	uint32_t result = 0;
+
+	for (int shift = 0; shift < 35; shift += 7) {
+		if (*pos >= len) {
+			return -EINVAL;
+		}
+
+		uint8_t byte = buf[(*pos)++];
+
+		/* The fifth byte only has room for the top four bits of 32 */
+		if (shift == 28 && (byte & 0xf0)) {
+			return -EINVAL;
+		}
+
+		result |= (uint32_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			*value = result;
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+static uint32_t zigzag_encode(int32_t value)
+{
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t value)
+{
+	return (int32_t)((value >> 1) ^ (0U - (value & 1)));
+}
+
+void sensor_codec_init(struct sensor_codec *codec, uint8_t *buf, size_t size)
+{
+	codec->buf = buf;
+	codec->size = size;
+	codec->len = 0;
+	codec->prev = 0;
+}
+
+int sensor_codec_add(struct sensor_codec *codec, uint32_t value)
+{
+	uint8_t tmp[SENSOR_CODEC_MAX_SAMPLE_LEN];
+	size_t count_len = codec->len ? 0 : 1;
+	size_t len;
+
+	if (codec->len == 0) {
+		/* Keyframe */
+		len = varint_put(tmp, value);
+	} else {
+		if (codec->buf[0] == UINT8_MAX) {
+			return -ENOMEM;
+		}
+		len = varint_put(tmp, zigzag_encode((int32_t)(value - codec->prev)));
+	}
+
+	if (codec->len + count_len + len > codec->size) {
+		return -ENOMEM;
+	}
+
+	if (count_len) {
+		codec->buf[0] = 0;
+		codec->len = 1;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		codec->buf[codec->len++] = tmp[i];
+	}
+	codec->buf[0]++;
+	codec->prev = value;
+
+	return 0;
+}
+
+int sensor_codec_decode(const uint8_t *buf, size_t len, uint32_t *values, size_t max_values)
+{
+	size_t pos = 1;
+	uint32_t raw;
+
+	if (len == 0 || buf[0] == 0 || buf[0] > max_values) {
+		return -EINVAL;
+	}
+
+	for (uint8_t i = 0; i < buf[0]; i++) {
+		if (varint_get(buf, len, &pos, &raw)) {
+			return -EINVAL;
+		}
+
+		values[i] = (i == 0) ? raw : values[i - 1] + (uint32_t)zigzag_decode(raw);
+	}
+
+	return (pos == len) ? buf[0] : -EINVAL;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SENSOR_CODEC_H_
+#define SENSOR_CODEC_H_
+
+/**@file
+ * @defgroup sensor_codec Compact sensor sample encoding
+ * @{
+ * @brief Zig-zag delta and varint encoding of a batch of sensor samples.
+ *
+ * A batch starts with a sample count byte, followed by a keyframe holding the
+ * absolute value of the first sample as an unsigned varint. Each following
+ * sample is stored as the zig-zag encoded difference to the previous one, also
+ * as a varint. Every batch starts with a new keyframe, so a client can decode
+ * any notification on its own.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <zephyr/types.h>
+
+/** @brief Maximum encoded size of a single sample. */
+#define SENSOR_CODEC_MAX_SAMPLE_LEN 5
+
+/** @brief Encoder state for one batch. */
+struct sensor_codec {
+	/** Output buffer. */
+	uint8_t *buf;
+	/** Size of the output buffer. */
+	size_t size;
+	/** Number of bytes used in the output buffer. */
+	size_t len;
+	/** Previous sample, used as the base of the next delta. */
+	uint32_t prev;
+};
+
+/** @brief Start a new batch.
+ *
+ * The next sample added is encoded as a keyframe.
+ *
+ * @param[in] codec Encoder state.
+ * @param[in] buf Output buffer, at least 1 + SENSOR_CODEC_MAX_SAMPLE_LEN bytes.
+ * @param[in] size Size of the output buffer.
+ */
+void sensor_codec_init(struct sensor_codec *codec, uint8_t *buf, size_t size);
+
+/** @brief Add a sample to the batch.
+ *
+ * @param[in] codec Encoder state.
+ * @param[in] value Sample value.
+ *
+ * @retval 0 If the sample was added.
+ * @retval -ENOMEM If the sample does not fit, the batch is left unchanged.
+ */
+int sensor_codec_add(struct sensor_codec *codec, uint32_t value);
+
+/** @brief Number of samples in the batch. */
+static inline uint8_t sensor_codec_count(const struct sensor_codec *codec)
+{
+	return codec->len ? codec->buf[0] : 0;
+}
+
+/** @brief Decode a batch.
+ *
+ * @param[in] buf Encoded batch.
+ * @param[in] len Length of the encoded batch.
+ * @param[out] values Decoded samples.
+ * @param[in] max_values Capacity of @p values.
+ *
+ * @return Number of decoded samples, or -EINVAL if the batch is malformed or
+ *         does not fit in @p values.
+ */
+int sensor_codec_decode(const uint8_t *buf, size_t len, uint32_t *values, size_t max_values);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* SENSOR_CODEC_H_ */
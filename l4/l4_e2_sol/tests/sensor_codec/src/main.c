@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Tests for the compact sensor sample encoding
+ */
+
+#include <errno.h>
+#include <zephyr/ztest.h>
+
+#include "sensor_codec.h"
+
+static uint8_t buf[300];
+static uint32_t decoded[300];
+static struct sensor_codec codec;
+
+static void encode(const uint32_t *values, size_t count)
+{
+	sensor_codec_init(&codec, buf, sizeof(buf));
+
+	for (size_t i = 0; i < count; i++) {
+		zassert_ok(sensor_codec_add(&codec, values[i]), "sample %zu not added", i);
+	}
+}
+
+static void assert_round_trip(const uint32_t *values, size_t count)
+{
+	encode(values, count);
+
+	zassert_equal(sensor_codec_count(&codec), count);
+	zassert_equal(sensor_codec_decode(buf, codec.len, decoded, ARRAY_SIZE(decoded)), count);
+	zassert_mem_equal(decoded, values, count * sizeof(values[0]));
+}
+
+ZTEST_SUITE(sensor_codec, NULL, NULL, NULL, NULL, NULL);
+
+ZTEST(sensor_codec, test_round_trip)
+{
+	static const uint32_t values[] = { 100, 101, 102, 150, 120, 199, 199, 0, UINT32_MAX, 0 };
+
+	assert_round_trip(values, ARRAY_SIZE(values));
+}
+
+ZTEST(sensor_codec, test_ramp_bytes_per_sample)
+{
+	uint32_t values[50];
+
+	for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+		values[i] = 100 + i;
+	}
+
+	assert_round_trip(values, ARRAY_SIZE(values));
+	/* Count byte, one byte keyframe for 100, then one byte per delta of 1 */
+	zassert_equal(codec.len, 1 + ARRAY_SIZE(values));
+}
+
+ZTEST(sensor_codec, test_wrap)
+{
+	static const uint32_t values[] = { 197, 198, 199, 100, 101, 102 };
+
+	assert_round_trip(values, ARRAY_SIZE(values));
+	/* Count byte, two byte keyframe, and the step from 199 down to 100 is the only
+	 * delta that takes two bytes.
+	 */
+	zassert_equal(codec.len, 1 + 2 + 1 + 1 + 2 + 1 + 1);
+}
+
+ZTEST(sensor_codec, test_batch_full)
+{
+	uint8_t small[8];
+	uint32_t value = 100;
+	size_t len;
+	uint8_t count;
+
+	sensor_codec_init(&codec, small, sizeof(small));
+
+	while (!sensor_codec_add(&codec, value)) {
+		value++;
+	}
+
+	/* Count byte, one byte keyframe and one byte deltas fill the buffer exactly */
+	zassert_equal(codec.len, sizeof(small));
+	count = sensor_codec_count(&codec);
+	zassert_equal(count, sizeof(small) - 1);
+
+	/* A failed add leaves the batch as it was */
+	len = codec.len;
+	zassert_equal(sensor_codec_add(&codec, 100), -ENOMEM);
+	zassert_equal(codec.len, len);
+	zassert_equal(sensor_codec_count(&codec), count);
+
+	zassert_equal(sensor_codec_decode(small, codec.len, decoded, ARRAY_SIZE(decoded)), count);
+	for (uint8_t i = 0; i < count; i++) {
+		zassert_equal(decoded[i], 100 + i);
+	}
+}
+
+ZTEST(sensor_codec, test_keyframe_does_not_fit)
+{
+	uint8_t small[3];
+
+	/* 100000 needs a three byte keyframe, which leaves no room for the count byte */
+	sensor_codec_init(&codec, small, sizeof(small));
+	zassert_equal(sensor_codec_add(&codec, 100000), -ENOMEM);
+	zassert_equal(codec.len, 0);
+	zassert_equal(sensor_codec_count(&codec), 0);
+}
+
+ZTEST(sensor_codec, test_count_limit)
+{
+	sensor_codec_init(&codec, buf, sizeof(buf));
+
+	for (int i = 0; i < UINT8_MAX; i++) {
+		zassert_ok(sensor_codec_add(&codec, 150));
+	}
+
+	/* The count byte is full before the buffer is */
+	zassert_true(codec.len < sizeof(buf));
+	zassert_equal(sensor_codec_add(&codec, 150), -ENOMEM);
+	zassert_equal(sensor_codec_count(&codec), UINT8_MAX);
+	zassert_equal(sensor_codec_decode(buf, codec.len, decoded, ARRAY_SIZE(decoded)),
+		      UINT8_MAX);
+}
+
+ZTEST(sensor_codec, test_decode_truncated)
+{
+	static const uint32_t values[] = { 100, 199, 100 };
+
+	encode(values, ARRAY_SIZE(values));
+
+	/* Cut inside the last two byte delta, then before it */
+	zassert_equal(sensor_codec_decode(buf, codec.len - 1, decoded, ARRAY_SIZE(decoded)),
+		      -EINVAL);
+	zassert_equal(sensor_codec_decode(buf, codec.len - 2, decoded, ARRAY_SIZE(decoded)),
+		      -EINVAL);
+	zassert_equal(sensor_codec_decode(buf, 1, decoded, ARRAY_SIZE(decoded)), -EINVAL);
+	zassert_equal(sensor_codec_decode(buf, 0, decoded, ARRAY_SIZE(decoded)), -EINVAL);
+}
+
+ZTEST(sensor_codec, test_decode_trailing_bytes)
+{
+	static const uint8_t batch[] = { 1, 100, 0 };
+
+	zassert_equal(sensor_codec_decode(batch, sizeof(batch), decoded, ARRAY_SIZE(decoded)),
+		      -EINVAL);
+}
+
+ZTEST(sensor_codec, test_decode_too_many_samples)
+{
+	static const uint32_t values[] = { 100, 101, 102 };
+
+	encode(values, ARRAY_SIZE(values));
+
+	zassert_equal(sensor_codec_decode(buf, codec.len, decoded, 2), -EINVAL);
+	zassert_equal(sensor_codec_decode(buf, codec.len, decoded, 3), 3);
+}
+
+ZTEST(sensor_codec, test_decode_empty_batch)
+{
+	static const uint8_t batch[] = { 0 };
+
+	zassert_equal(sensor_codec_decode(batch, sizeof(batch), decoded, ARRAY_SIZE(decoded)),
+		      -EINVAL);
+}
+
+ZTEST(sensor_codec, test_decode_long_varint)
+{
+	/* UINT32_MAX takes all five bytes */
+	static const uint8_t max[] = { 1, 0xff, 0xff, 0xff, 0xff, 0x0f };
+	/* Bits above 32 in the fifth byte */
+	static const uint8_t overflow[] = { 1, 0xff, 0xff, 0xff, 0xff, 0x1f };
+	/* Six bytes, even if the value would fit */
+	static const uint8_t over_long[] = { 1, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00 };
+
+	zassert_equal(sensor_codec_decode(max, sizeof(max), decoded, ARRAY_SIZE(decoded)), 1);
+	zassert_equal(decoded[0], UINT32_MAX);
+
+	zassert_equal(sensor_codec_decode(overflow, sizeof(overflow), decoded,
+					  ARRAY_SIZE(decoded)), -EINVAL);
+	zassert_equal(sensor_codec_decode(over_long, sizeof(over_long), decoded,
+					  ARRAY_SIZE(decoded)), -EINVAL);
+}
@@ -60,6 +60,11 @@ static struct bt_conn *current_conn;
 static struct bt_conn *auth_conn;
 static struct k_work adv_work;
 
+/* Uptime of the last connection, used to time how fast the central resumes */
+static int64_t conn_start_time;
+static bool first_rx_logged;
+static bool first_tx_logged;
+
 static const struct device *uart = DEVICE_DT_GET(DT_CHOSEN(nordic_nus_uart));
 static struct k_work_delayable uart_work;
 /* STEP 6.2 - Declare the struct of the data item of the FIFOs */
@@ -347,6 +352,10 @@ static void connected(struct bt_conn *conn, uint8_t err)
 	bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
 	LOG_INF("Connected %s", addr);
 
+	conn_start_time = k_uptime_get();
+	first_rx_logged = false;
+	first_tx_logged = false;
+
 	current_conn = bt_conn_ref(conn);
 
 	dk_set_led_on(CON_STATUS_LED);
@@ -478,6 +487,11 @@ static void bt_receive_cb(struct bt_conn *conn, const uint8_t *const data, uint1
 
 	LOG_INF("Received data from: %s", addr);
 
+	if (!first_rx_logged) {
+		first_rx_logged = true;
+		LOG_INF("First NUS data %lld ms after connection", k_uptime_get() - conn_start_time);
+	}
+
 	for (uint16_t pos = 0; pos != len;) {
 		struct uart_data_t *tx = k_malloc(sizeof(*tx));
 
@@ -513,9 +527,29 @@ static void bt_receive_cb(struct bt_conn *conn, const uint8_t *const data, uint1
 		}
 	}
 }
+static void bt_send_enabled_cb(enum bt_nus_send_status status)
+{
+	LOG_INF("NUS notifications %s",
+		status == BT_NUS_SEND_STATUS_ENABLED ? "enabled" : "disabled");
+}
+
+static void bt_sent_cb(struct bt_conn *conn)
+{
+	/* The first notification that went out is when the central could use the link,
+	 * with GATT caching it skips service discovery before subscribing.
+	 */
+	if (!first_tx_logged) {
+		first_tx_logged = true;
+		LOG_INF("First NUS notification sent %lld ms after connection",
+			k_uptime_get() - conn_start_time);
+	}
+}
+
 /* STEP 8.1 - Create a variable of type bt_nus_cb and initialize it */
 static struct bt_nus_cb nus_cb = {
 	.received = bt_receive_cb,
+	.send_enabled = bt_send_enabled_cb,
+	.sent = bt_sent_cb,
 };
 
 void error(void)
@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+#
+# Copyright (c) 2023 Nordic Semiconductor
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+# Run the pairing benchmark central against the Lesson 5 Exercise 1 peripheral in BabbleSim.
+#
+# Build both images for the simulated board first:
+#   west build -b nrf52_bsim -d build_peripheral ../l5_e1_sol -- -DEXTRA_CONF_FILE=pairing_bench.conf
+#   west build -b nrf52_bsim -d build_central .
+#
+# To time reconnections to Lesson 5 Exercise 2, which advertises directed to its last
+# bonded peer after a disconnection, build that peripheral and this central with:
+#   west build -b nrf52_bsim -d build_peripheral ../l5_e2_sol -- \
+#     -DEXTRA_CONF_FILE="pairing_bench.conf;directed_reconnect.conf"
+#   west build -b nrf52_bsim -d build_central . -- -DEXTRA_CONF_FILE=reconnect.conf
+#
+# To time the first button notification with and without GATT Robust Caching, build
+# Lesson 5 Exercise 2 once with each overlay and this central with gatt_bench.conf:
+#   west build -b nrf52_bsim -d build_peripheral ../l5_e2_sol -- \
+#     -DEXTRA_CONF_FILE="pairing_bench.conf;gatt_caching.conf"
+#   west build -b nrf52_bsim -d build_central . -- -DEXTRA_CONF_FILE=gatt_bench.conf
+#
+# Usage: ./pairing_bsim.sh <peripheral exe> <central exe> [seconds]
+#
+# The output of both devices is written to pairing_central.log and pairing_peripheral.log.
+# The central ends with the minimum, average and maximum time to reach the security level
+# for Just Works, passkey entry and reconnection with the stored LTK, and with
+# gatt_bench.conf the time to the first button notification.
+
+set -euo pipefail
+
+if [ $# -lt 2 ]; then
+	echo "Usage: $0 <peripheral exe> <central exe> [seconds]" >&2
+	exit 1
+fi
+
+: "${BSIM_OUT_PATH:?BSIM_OUT_PATH must point to the BabbleSim output directory}"
+
+PERIPHERAL_EXE=$(realpath "$1")
+CENTRAL_EXE=$(realpath "$2")
+SECONDS_SIM=${3:-300}
+SIM_ID="bt_fund_pairing"
+
+CENTRAL_LOG="$(pwd)/pairing_central.log"
+PERIPHERAL_LOG="$(pwd)/pairing_peripheral.log"
+
+cd "${BSIM_OUT_PATH}/bin"
+
+"$CENTRAL_EXE" -s="$SIM_ID" -d=0 -rs=0 > "$CENTRAL_LOG" 2>&1 &
+"$PERIPHERAL_EXE" -s="$SIM_ID" -d=1 -rs=1 > "$PERIPHERAL_LOG" 2>&1 &
+
+./bs_2G4_phy_v1 -s="$SIM_ID" -D=2 -sim_length=$((SECONDS_SIM * 1000000))
+
+wait
+
+echo "Central output: $CENTRAL_LOG"
+sed -n '/Time to security level/,$p' "$CENTRAL_LOG"
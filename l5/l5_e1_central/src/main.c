@@ -0,0 +1,589 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Scripted central that pairs with the Lesson 5 Exercise 1 peripheral
+ *  again and again and reports the time to reach the requested security level
+ *  for Just Works, passkey entry and reconnection with a stored LTK. Reconnections
+ *  go straight to the bonded peer without scanning, so their connection time shows
+ *  how fast the peripheral advertises again, for example with directed advertising.
+ *  Optionally each run also times the first LBS button notification, which shows
+ *  what GATT Robust Caching saves on reconnection.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gap.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/uuid.h>
+
+LOG_MODULE_REGISTER(Lesson5_Exercise1_Central, LOG_LEVEL_INF);
+
+#define TARGET_NAME CONFIG_BENCH_TARGET_NAME
+#define TARGET_NAME_LEN (sizeof(TARGET_NAME) - 1)
+
+#define SCAN_TIMEOUT K_SECONDS(10)
+#define CONNECT_TIMEOUT K_SECONDS(10)
+#define SECURITY_TIMEOUT K_SECONDS(30)
+#define GATT_TIMEOUT K_SECONDS(5)
+#define NOTIFY_TIMEOUT K_SECONDS(5)
+
+/* LBS Button characteristic, which the peripheral notifies to new subscribers */
+static const struct bt_uuid_128 button_uuid = BT_UUID_INIT_128(
+	BT_UUID_128_ENCODE(0x00001524, 0x1212, 0xefde, 0x1523, 0x785feabcd123));
+
+/* Fresh pairings come first. The peripheral keeps the bond of the previous run, and
+ * lets a Just Works pairing replace it only with BT_SMP_ALLOW_UNAUTH_OVERWRITE, see
+ * pairing_bench.conf, and only while it is unauthenticated. So Just Works runs before
+ * passkey entry, and the reconnections reuse the bond left by the last pairing run.
+ */
+enum bench_method {
+	BENCH_JUST_WORKS,
+	BENCH_PASSKEY,
+	BENCH_RECONNECT,
+	BENCH_METHOD_COUNT,
+};
+
+static const struct {
+	const char *name;
+	bt_security_t level;
+	bool pair;
+} methods[BENCH_METHOD_COUNT] = {
+	[BENCH_JUST_WORKS] = { "Just Works", BT_SECURITY_L2, true },
+	[BENCH_PASSKEY] = { "Passkey", BT_SECURITY_L3, true },
+	[BENCH_RECONNECT] = { "Reconnection", BT_SECURITY_L2, false },
+};
+
+/* Result of one run */
+struct bench_result {
+	uint32_t connect_us;
+	uint32_t security_us;
+	uint32_t notify_us;
+	bool discovered;
+};
+
+struct bench_stats {
+	uint32_t runs;
+	uint32_t failures;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t sum_us;
+	uint32_t connect_max_us;
+	uint64_t connect_sum_us;
+	uint32_t notify_max_us;
+	uint64_t notify_sum_us;
+	uint32_t discoveries;
+};
+
+static K_SEM_DEFINE(sem_found, 0, 1);
+static K_SEM_DEFINE(sem_connected, 0, 1);
+static K_SEM_DEFINE(sem_security, 0, 1);
+static K_SEM_DEFINE(sem_disconnected, 0, 1);
+static K_SEM_DEFINE(sem_gatt, 0, 1);
+static K_SEM_DEFINE(sem_notified, 0, 1);
+
+static struct bt_conn *conn;
+static bt_addr_le_t peer_addr;
+/* Set once a pairing run has bonded with peer_addr, which reconnection needs */
+static bool bonded;
+
+static int64_t security_start;
+static uint32_t security_us;
+static bt_security_t security_level;
+static enum bt_security_err security_err;
+
+static int64_t connected_at;
+static int64_t notified_at;
+
+/* Database Hash of the bonded peer, for which the subscription is kept */
+static struct {
+	bool valid;
+	uint8_t hash[16];
+} gatt_cache;
+
+static uint8_t read_hash[16];
+static bool read_hash_ok;
+
+static struct bt_gatt_read_params read_params;
+static struct bt_gatt_discover_params discover_params;
+static struct bt_gatt_discover_params ccc_discover_params;
+static struct bt_gatt_subscribe_params subscribe_params;
+
+static bool name_match_cb(struct bt_data *data, void *user_data)
+{
+	bool *match = user_data;
+
+	if (data->type == BT_DATA_NAME_COMPLETE || data->type == BT_DATA_NAME_SHORTENED) {
+		*match = (data->data_len == TARGET_NAME_LEN) &&
+			 !memcmp(data->data, TARGET_NAME, TARGET_NAME_LEN);
+		return false;
+	}
+
+	return true;
+}
+
+static void scan_recv(const struct bt_le_scan_recv_info *info, struct net_buf_simple *buf)
+{
+	bool match = false;
+
+	if (!(info->adv_props & BT_GAP_ADV_PROP_CONNECTABLE)) {
+		return;
+	}
+
+	bt_data_parse(buf, name_match_cb, &match);
+	if (!match) {
+		return;
+	}
+
+	bt_addr_le_copy(&peer_addr, info->addr);
+	k_sem_give(&sem_found);
+}
+
+static struct bt_le_scan_cb scan_callbacks = {
+	.recv = scan_recv,
+};
+
+static void on_connected(struct bt_conn *connected, uint8_t err)
+{
+	if (err) {
+		LOG_WRN("Connection failed (err %u)\n", err);
+		bt_conn_unref(conn);
+		conn = NULL;
+	} else {
+		connected_at = k_uptime_ticks();
+		notified_at = 0;
+		k_sem_reset(&sem_notified);
+	}
+
+	k_sem_give(&sem_connected);
+}
+
+static void on_disconnected(struct bt_conn *disconnected, uint8_t reason)
+{
+	/* After pairing this is the identity address, which reconnection uses */
+	bt_addr_le_copy(&peer_addr, bt_conn_get_dst(disconnected));
+
+	bt_conn_unref(conn);
+	conn = NULL;
+
+	k_sem_give(&sem_disconnected);
+}
+
+static void on_security_changed(struct bt_conn *secured, bt_security_t level,
+				enum bt_security_err err)
+{
+	security_us = k_ticks_to_us_floor32(k_uptime_ticks() - security_start);
+	security_level = level;
+	security_err = err;
+
+	k_sem_give(&sem_security);
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+	.connected = on_connected,
+	.disconnected = on_disconnected,
+	.security_changed = on_security_changed,
+};
+
+static void auth_passkey_entry(struct bt_conn *entry_conn)
+{
+	/* Stands in for the user typing the passkey shown by the peripheral */
+	bt_conn_auth_passkey_entry(entry_conn, CONFIG_BENCH_PASSKEY);
+}
+
+static void auth_cancel(struct bt_conn *cancelled)
+{
+	LOG_INF("Pairing cancelled\n");
+}
+
+/* Keyboard only against the display of the peripheral selects passkey entry */
+static struct bt_conn_auth_cb auth_passkey_callbacks = {
+	.passkey_entry = auth_passkey_entry,
+	.cancel = auth_cancel,
+};
+
+static int set_method(enum bench_method method)
+{
+	int err;
+
+	/* Without callbacks the central has no input or output, so pairing is Just Works */
+	bt_conn_auth_cb_register(NULL);
+	if (method == BENCH_JUST_WORKS) {
+		return 0;
+	}
+
+	err = bt_conn_auth_cb_register(&auth_passkey_callbacks);
+	if (err) {
+		LOG_ERR("Failed to register authorization callbacks (err %d)\n", err);
+	}
+
+	return err;
+}
+
+static int find_peer(void)
+{
+	int err;
+
+	k_sem_reset(&sem_found);
+
+	err = bt_le_scan_start(BT_LE_SCAN_PASSIVE, NULL);
+	if (err) {
+		LOG_ERR("Scanning failed to start (err %d)\n", err);
+		return err;
+	}
+
+	err = k_sem_take(&sem_found, SCAN_TIMEOUT);
+	bt_le_scan_stop();
+	if (err) {
+		LOG_WRN("%s not found\n", TARGET_NAME);
+	}
+
+	return err;
+}
+
+static int bench_connect(bool scan, uint32_t *connect_us)
+{
+	int64_t connect_start;
+	int err;
+
+	if (scan) {
+		err = find_peer();
+		if (err) {
+			return err;
+		}
+	}
+
+	connect_start = k_uptime_ticks();
+	err = bt_conn_le_create(&peer_addr, BT_CONN_LE_CREATE_CONN, BT_LE_CONN_PARAM_DEFAULT,
+				&conn);
+	if (err) {
+		LOG_ERR("Failed to create connection (err %d)\n", err);
+		return err;
+	}
+
+	if (k_sem_take(&sem_connected, CONNECT_TIMEOUT) || !conn) {
+		if (conn) {
+			/* Cancels the pending connection, disconnected() drops the reference */
+			bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+			k_sem_take(&sem_disconnected, K_FOREVER);
+		}
+		return -ENOTCONN;
+	}
+
+	*connect_us = k_ticks_to_us_floor32(k_uptime_ticks() - connect_start);
+
+	return 0;
+}
+
+static uint8_t hash_read(struct bt_conn *read_conn, uint8_t err,
+			 struct bt_gatt_read_params *params, const void *data, uint16_t length)
+{
+	/* A peer without Robust Caching has no Database Hash and answers with an error */
+	read_hash_ok = !err && data && length == sizeof(read_hash);
+	if (read_hash_ok) {
+		memcpy(read_hash, data, length);
+	}
+
+	k_sem_give(&sem_gatt);
+
+	return BT_GATT_ITER_STOP;
+}
+
+static uint8_t button_discovered(struct bt_conn *disc_conn, const struct bt_gatt_attr *attr,
+				 struct bt_gatt_discover_params *params)
+{
+	if (attr) {
+		subscribe_params.value_handle = bt_gatt_attr_value_handle(attr);
+	}
+
+	k_sem_give(&sem_gatt);
+
+	return BT_GATT_ITER_STOP;
+}
+
+static uint8_t button_notified(struct bt_conn *notified_conn,
+			       struct bt_gatt_subscribe_params *params, const void *data,
+			       uint16_t length)
+{
+	if (!data) {
+		/* Unsubscribed */
+		k_sem_give(&sem_gatt);
+		return BT_GATT_ITER_STOP;
+	}
+
+	if (!notified_at) {
+		notified_at = k_uptime_ticks();
+		k_sem_give(&sem_notified);
+	}
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+static int gatt_read_hash(void)
+{
+	int err;
+
+	read_params.func = hash_read;
+	read_params.handle_count = 0;
+	read_params.by_uuid.uuid = BT_UUID_GATT_DB_HASH;
+	read_params.by_uuid.start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE;
+	read_params.by_uuid.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
+
+	k_sem_reset(&sem_gatt);
+
+	err = bt_gatt_read(conn, &read_params);
+	if (err) {
+		LOG_ERR("Failed to read the Database Hash (err %d)\n", err);
+		return err;
+	}
+
+	return k_sem_take(&sem_gatt, GATT_TIMEOUT);
+}
+
+static int gatt_subscribe(bool keep)
+{
+	int err;
+
+	subscribe_params.value_handle = 0;
+
+	discover_params.uuid = &button_uuid.uuid;
+	discover_params.func = button_discovered;
+	discover_params.start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE;
+	discover_params.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
+	discover_params.type = BT_GATT_DISCOVER_CHARACTERISTIC;
+
+	k_sem_reset(&sem_gatt);
+
+	err = bt_gatt_discover(conn, &discover_params);
+	if (err || k_sem_take(&sem_gatt, GATT_TIMEOUT) || !subscribe_params.value_handle) {
+		LOG_WRN("Button characteristic not found\n");
+		return -ENOENT;
+	}
+
+	subscribe_params.notify = button_notified;
+	subscribe_params.value = BT_GATT_CCC_NOTIFY;
+	subscribe_params.ccc_handle = BT_GATT_AUTO_DISCOVER_CCC_HANDLE;
+	subscribe_params.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
+	subscribe_params.disc_params = &ccc_discover_params;
+
+	/* Without a Database Hash the handles cannot be trusted on the next connection,
+	 * so the subscription goes away with it.
+	 */
+	if (keep) {
+		atomic_clear_bit(subscribe_params.flags, BT_GATT_SUBSCRIBE_FLAG_VOLATILE);
+	} else {
+		atomic_set_bit(subscribe_params.flags, BT_GATT_SUBSCRIBE_FLAG_VOLATILE);
+	}
+
+	err = bt_gatt_subscribe(conn, &subscribe_params);
+	if (err) {
+		LOG_ERR("Failed to subscribe (err %d)\n", err);
+	}
+
+	return err;
+}
+
+static int gatt_bench(struct bench_result *result)
+{
+	int err;
+
+	result->discovered = false;
+
+	err = gatt_read_hash();
+	if (err) {
+		return err;
+	}
+
+	/* With an unchanged Database Hash the subscription kept with the bond is still
+	 * right, and the peripheral restores its side of it, so nothing is sent.
+	 */
+	if (!gatt_cache.valid || !read_hash_ok ||
+	    memcmp(read_hash, gatt_cache.hash, sizeof(read_hash))) {
+		if (gatt_cache.valid) {
+			gatt_cache.valid = false;
+			k_sem_reset(&sem_gatt);
+			if (!bt_gatt_unsubscribe(conn, &subscribe_params)) {
+				k_sem_take(&sem_gatt, GATT_TIMEOUT);
+			}
+			/* A notification on the old handle does not count */
+			notified_at = 0;
+			k_sem_reset(&sem_notified);
+		}
+
+		err = gatt_subscribe(read_hash_ok);
+		if (err) {
+			return err;
+		}
+
+		result->discovered = true;
+		gatt_cache.valid = read_hash_ok;
+		memcpy(gatt_cache.hash, read_hash, sizeof(gatt_cache.hash));
+	}
+
+	if (k_sem_take(&sem_notified, NOTIFY_TIMEOUT)) {
+		LOG_WRN("No button notification\n");
+		return -ETIMEDOUT;
+	}
+
+	result->notify_us = k_ticks_to_us_floor32(notified_at - connected_at);
+
+	return 0;
+}
+
+static int bench_run(enum bench_method method, struct bench_result *result)
+{
+	int err;
+
+	if (methods[method].pair) {
+		/* Also drops the subscription kept with the bond */
+		bt_unpair(BT_ID_DEFAULT, BT_ADDR_LE_ANY);
+		gatt_cache.valid = false;
+		bonded = false;
+	}
+
+	err = bench_connect(methods[method].pair, &result->connect_us);
+	if (err) {
+		return err;
+	}
+
+	k_sem_reset(&sem_security);
+	security_start = k_uptime_ticks();
+
+	err = bt_conn_set_security(conn, methods[method].level);
+	if (err) {
+		LOG_ERR("Failed to set security (err %d)\n", err);
+	} else if (k_sem_take(&sem_security, SECURITY_TIMEOUT)) {
+		LOG_WRN("Security timed out\n");
+		err = -ETIMEDOUT;
+	} else if (security_err || security_level < methods[method].level) {
+		LOG_WRN("Security failed: level %u err %d\n", security_level, security_err);
+		/* The peripheral dropped the bond, so later reconnections would fail too */
+		if (security_err == BT_SECURITY_ERR_PIN_OR_KEY_MISSING) {
+			bonded = false;
+		}
+		err = -EACCES;
+	} else {
+		result->security_us = security_us;
+		bonded = true;
+		if (IS_ENABLED(CONFIG_BENCH_GATT)) {
+			err = gatt_bench(result);
+		}
+	}
+
+	bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+	k_sem_take(&sem_disconnected, K_FOREVER);
+
+	return err;
+}
+
+static void bench_method(enum bench_method method, struct bench_stats *stats)
+{
+	struct bench_result result;
+
+	stats->min_us = UINT32_MAX;
+
+	if (method == BENCH_PASSKEY && !IS_ENABLED(CONFIG_BENCH_PASSKEY_PAIRING)) {
+		return;
+	}
+
+	if (method == BENCH_RECONNECT && !bonded) {
+		LOG_WRN("No bond from the pairing runs, skipping reconnections\n");
+		stats->failures = CONFIG_BENCH_RUNS;
+		return;
+	}
+
+	for (int run = 1; run <= CONFIG_BENCH_RUNS; run++) {
+		if (bench_run(method, &result)) {
+			stats->failures++;
+			if (method == BENCH_RECONNECT && !bonded) {
+				LOG_WRN("Bond lost, stopping reconnections\n");
+				stats->failures += CONFIG_BENCH_RUNS - run;
+				break;
+			}
+			continue;
+		}
+
+		LOG_INF("%s run %d: connected in %u us, level %u in %u us\n",
+			methods[method].name, run, result.connect_us, security_level,
+			result.security_us);
+
+		stats->runs++;
+		stats->sum_us += result.security_us;
+		stats->min_us = MIN(stats->min_us, result.security_us);
+		stats->max_us = MAX(stats->max_us, result.security_us);
+		stats->connect_sum_us += result.connect_us;
+		stats->connect_max_us = MAX(stats->connect_max_us, result.connect_us);
+
+		if (IS_ENABLED(CONFIG_BENCH_GATT)) {
+			LOG_INF("%s run %d: first notification %u us after connection%s\n",
+				methods[method].name, run, result.notify_us,
+				result.discovered ? ", discovered" : "");
+
+			stats->notify_sum_us += result.notify_us;
+			stats->notify_max_us = MAX(stats->notify_max_us, result.notify_us);
+			stats->discoveries += result.discovered;
+		}
+	}
+}
+
+int main(void)
+{
+	struct bench_stats stats[BENCH_METHOD_COUNT] = { 0 };
+	int err;
+
+	LOG_INF("Starting Lesson 5 - Exercise 1 pairing benchmark\n");
+
+	err = bt_enable(NULL);
+	if (err) {
+		LOG_ERR("Bluetooth init failed (err %d)\n", err);
+		return -1;
+	}
+
+	LOG_INF("Bluetooth initialized\n");
+
+	bt_le_scan_cb_register(&scan_callbacks);
+
+	for (int method = 0; method < BENCH_METHOD_COUNT; method++) {
+		if (set_method(method)) {
+			return -1;
+		}
+
+		bench_method(method, &stats[method]);
+	}
+
+	LOG_INF("Time to security level, %d runs per method:\n", CONFIG_BENCH_RUNS);
+
+	for (int method = 0; method < BENCH_METHOD_COUNT; method++) {
+		if (!stats[method].runs && !stats[method].failures) {
+			continue;
+		}
+
+		if (!stats[method].runs) {
+			LOG_INF("  %-12s all %u runs failed\n", methods[method].name,
+				stats[method].failures);
+			continue;
+		}
+
+		LOG_INF("  %-12s min %7u us, avg %7u us, max %7u us, %u failed\n",
+			methods[method].name, stats[method].min_us,
+			(uint32_t)(stats[method].sum_us / stats[method].runs), stats[method].max_us,
+			stats[method].failures);
+		LOG_INF("  %-12s connected in avg %7u us, max %7u us\n", "",
+			(uint32_t)(stats[method].connect_sum_us / stats[method].runs),
+			stats[method].connect_max_us);
+		if (IS_ENABLED(CONFIG_BENCH_GATT)) {
+			LOG_INF("  %-12s first notification in avg %7u us, max %7u us, "
+				"%u discoveries\n", "",
+				(uint32_t)(stats[method].notify_sum_us / stats[method].runs),
+				stats[method].notify_max_us, stats[method].discoveries);
+		}
+	}
+
+	return 0;
+}
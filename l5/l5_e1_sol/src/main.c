@@ -13,6 +13,7 @@
 #include <dk_buttons_and_leds.h>
 
 #include "lbs.h"
+#include "pairing_timing.h"
 
 LOG_MODULE_REGISTER(Lesson5_Exercise1, LOG_LEVEL_INF);
 
@@ -28,6 +29,9 @@ LOG_MODULE_REGISTER(Lesson5_Exercise1, LOG_LEVEL_INF);
 
 static bool app_button_state;
 static struct k_work adv_work;
+
+/* Uptime of the last connection in ticks, to time how long security takes */
+static int64_t conn_start_time;
 static const struct bt_data ad[] = {
 	BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
 	BT_DATA(BT_DATA_NAME_COMPLETE, DEVICE_NAME, DEVICE_NAME_LEN),
@@ -63,6 +67,10 @@ static void on_connected(struct bt_conn *conn, uint8_t err)
 	}
 
 	LOG_INF("Connected\n");
+	conn_start_time = k_uptime_ticks();
+	if (IS_ENABLED(CONFIG_PAIRING_TIMING)) {
+		pairing_timing_mark(PAIRING_PHASE_CONNECTED);
+	}
 
 	dk_set_led_on(CON_STATUS_LED);
 }
@@ -90,6 +98,11 @@ static void on_security_changed(struct bt_conn *conn, bt_security_t level, enum
 
 	if (!err) {
 		LOG_INF("Security changed: %s level %u\n", addr, level);
+		LOG_INF("Security level %u reached %u us after connection\n", level,
+			k_ticks_to_us_floor32(k_uptime_ticks() - conn_start_time));
+		if (IS_ENABLED(CONFIG_PAIRING_TIMING)) {
+			pairing_timing_mark(PAIRING_PHASE_ENCRYPTED);
+		}
 	} else {
 		LOG_INF("Security failed: %s level %u err %d\n", addr, level, err);
 	}
@@ -109,6 +122,11 @@ static void auth_passkey_display(struct bt_conn *conn, unsigned int passkey)
 
 	bt_addr_le_to_str(bt_conn_get_dst(conn), addr, sizeof(addr));
 
+	/* With LE Secure Connections the passkey is shown once the public keys are exchanged */
+	if (IS_ENABLED(CONFIG_PAIRING_TIMING)) {
+		pairing_timing_mark(PAIRING_PHASE_PUBLIC_KEY);
+	}
+
 	LOG_INF("Passkey for %s: %06u\n", addr, passkey);
 }
 
@@ -122,10 +140,40 @@ static void auth_cancel(struct bt_conn *conn)
 	LOG_INF("Pairing cancelled: %s\n", addr);
 }
 
+#if defined(CONFIG_PAIRING_TIMING)
+static enum bt_security_err auth_pairing_accept(struct bt_conn *conn,
+						const struct bt_conn_pairing_feat *const feat)
+{
+	pairing_timing_mark(PAIRING_PHASE_FEATURES);
+
+	return BT_SECURITY_ERR_SUCCESS;
+}
+
+static void pairing_complete(struct bt_conn *conn, bool bonded)
+{
+	pairing_timing_mark(PAIRING_PHASE_KEY_DIST);
+	pairing_timing_report(true);
+}
+
+static void pairing_failed(struct bt_conn *conn, enum bt_security_err reason)
+{
+	LOG_INF("Pairing failed (reason %d)\n", reason);
+	pairing_timing_report(false);
+}
+
+static struct bt_conn_auth_info_cb conn_auth_info_callbacks = {
+	.pairing_complete = pairing_complete,
+	.pairing_failed = pairing_failed,
+};
+#endif
+
 /* STEP 9.3 - Declare the authenticated pairing callback structure */
 static struct bt_conn_auth_cb conn_auth_callbacks = {
 	.passkey_display = auth_passkey_display,
 	.cancel = auth_cancel,
+#if defined(CONFIG_PAIRING_TIMING)
+	.pairing_accept = auth_pairing_accept,
+#endif
 };
 
 static void app_led_cb(bool led_state)
@@ -150,6 +198,7 @@ static void button_changed(uint32_t button_state, uint32_t has_changed)
 
 		bt_lbs_send_button_state(user_button_state);
 		app_button_state = user_button_state ? true : false;
+		bt_lbs_set_button_state(app_button_state);
 	}
 }
 
@@ -191,6 +240,14 @@ int main(void)
 		return -1;
 	}
 
+#if defined(CONFIG_PAIRING_TIMING)
+	err = bt_conn_auth_info_cb_register(&conn_auth_info_callbacks);
+	if (err) {
+		LOG_INF("Failed to register authorization info callbacks\n");
+		return -1;
+	}
+#endif
+
 	bt_conn_cb_register(&connection_callbacks);
 
 	err = bt_enable(NULL);
@@ -199,6 +256,31 @@ int main(void)
 		return -1;
 	}
 
+#if defined(CONFIG_BT_FIXED_PASSKEY)
+	/* A known passkey lets a scripted central enter it, see pairing_bench.conf */
+	err = bt_passkey_set(CONFIG_FIXED_PASSKEY_VALUE);
+	if (err) {
+		LOG_INF("Failed to set passkey (err %d)\n", err);
+		return -1;
+	}
+#endif
+
+	if (IS_ENABLED(CONFIG_LESC_KEY_PREGEN)) {
+		struct bt_le_oob oob;
+		int64_t key_wait_start = k_uptime_get();
+
+		/* The host starts generating its P-256 key pair in bt_enable(). Getting the
+		 * local OOB data waits for it, so no central can pair before it is ready.
+		 */
+		err = bt_le_oob_get_local(BT_ID_DEFAULT, &oob);
+		if (err) {
+			LOG_INF("LESC public key not available (err %d)\n", err);
+		} else {
+			LOG_INF("LESC public key ready after %lld ms\n",
+				k_uptime_get() - key_wait_start);
+		}
+	}
+
 	err = bt_lbs_init(&lbs_callbacs);
 	if (err) {
 		LOG_INF("Failed to init LBS (err:%d)\n", err);
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Pairing phase timing
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "pairing_timing.h"
+
+LOG_MODULE_DECLARE(Lesson5_Exercise1);
+
+static const char *const phase_name[PAIRING_PHASE_COUNT] = {
+	[PAIRING_PHASE_CONNECTED] = "connected",
+	[PAIRING_PHASE_FEATURES] = "pairing request",
+	[PAIRING_PHASE_PUBLIC_KEY] = "public key",
+	[PAIRING_PHASE_ENCRYPTED] = "DHKey check, encryption",
+	[PAIRING_PHASE_KEY_DIST] = "key distribution",
+};
+
+/* Uptime in ticks at the end of each phase, 0 if not reached */
+static int64_t phase_end[PAIRING_PHASE_COUNT];
+
+void pairing_timing_mark(enum pairing_phase phase)
+{
+	if (phase == PAIRING_PHASE_CONNECTED) {
+		memset(phase_end, 0, sizeof(phase_end));
+	}
+
+	phase_end[phase] = k_uptime_ticks();
+}
+
+void pairing_timing_report(bool success)
+{
+	int64_t prev = phase_end[PAIRING_PHASE_CONNECTED];
+
+	if (!prev) {
+		return;
+	}
+
+	LOG_INF("Pairing %s:\n", success ? "complete" : "failed");
+
+	for (int i = PAIRING_PHASE_FEATURES; i < PAIRING_PHASE_COUNT; i++) {
+		const char *name = phase_name[i];
+
+		if (!phase_end[i]) {
+			continue;
+		}
+
+		/* Just Works has no callback between the feature and DHKey check phases */
+		if (i == PAIRING_PHASE_ENCRYPTED && !phase_end[PAIRING_PHASE_PUBLIC_KEY]) {
+			name = "public key, DHKey check, encryption";
+		}
+
+		LOG_INF("  %-36s %6u us\n", name, k_ticks_to_us_floor32(phase_end[i] - prev));
+		prev = phase_end[i];
+	}
+
+	LOG_INF("  %-36s %6u us\n", "total",
+		k_ticks_to_us_floor32(prev - phase_end[PAIRING_PHASE_CONNECTED]));
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef PAIRING_TIMING_H_
+#define PAIRING_TIMING_H_
+
+/**@file
+ * @defgroup pairing_timing Pairing phase timing
+ * @{
+ * @brief Timestamps of the LE Secure Connections pairing phases.
+ *
+ * The phases are seen through the application callbacks the host calls as
+ * pairing progresses, so each one ends when the matching callback runs:
+ *
+ * - PAIRING_PHASE_FEATURES: pairing_accept(), the Pairing Request was received,
+ * - PAIRING_PHASE_PUBLIC_KEY: passkey_display(), the public keys were
+ *   exchanged. No callback marks this with Just Works,
+ * - PAIRING_PHASE_ENCRYPTED: security_changed(), the DHKey checks passed and
+ *   encryption has started; with passkey entry this includes the user typing,
+ * - PAIRING_PHASE_KEY_DIST: pairing_complete(), the keys were distributed.
+ *
+ * Without the public key mark, the report names the next phase for what it
+ * brackets: public key exchange, DHKey check and encryption together.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+/** @brief Pairing phases, in the order they end. */
+enum pairing_phase {
+	PAIRING_PHASE_CONNECTED,
+	PAIRING_PHASE_FEATURES,
+	PAIRING_PHASE_PUBLIC_KEY,
+	PAIRING_PHASE_ENCRYPTED,
+	PAIRING_PHASE_KEY_DIST,
+	PAIRING_PHASE_COUNT,
+};
+
+/** @brief Record the end of a phase.
+ *
+ * PAIRING_PHASE_CONNECTED starts a new measurement.
+ *
+ * @param[in] phase Phase that just ended.
+ */
+void pairing_timing_mark(enum pairing_phase phase);
+
+/** @brief Log the duration of each phase reached.
+ *
+ * @param[in] success Whether pairing completed.
+ */
+void pairing_timing_report(bool success);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* PAIRING_TIMING_H_ */
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Filter Accept List maintenance
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/hci.h>
+
+#include "accept_list.h"
+#include "bond_mgr.h"
+
+LOG_MODULE_DECLARE(Lesson5_Exercise2);
+
+static bool synced;
+static int entries;
+
+/* HCI commands issued since the last sync, and totals for the savings report */
+static uint32_t pending_cmds;
+static uint32_t total_cmds;
+static uint32_t total_cmds_rebuild;
+/* Duration of the last rebuild, to estimate the time per HCI command */
+static uint32_t rebuild_us;
+static uint32_t rebuild_cmds;
+
+#if defined(CONFIG_BT_PRIVACY)
+/* Controller resolving list size, read on the first sync */
+static int rl_size = -1;
+#endif
+static bool host_filter;
+
+static void rebuild_add(const bt_addr_le_t *addr, int *bond_cnt)
+{
+	int err;
+
+	if ((*bond_cnt) < 0) {
+		return;
+	}
+
+	err = bt_le_filter_accept_list_add(addr);
+	pending_cmds++;
+	if (err) {
+		LOG_INF("Cannot add peer to filter accept list (err: %d)\n", err);
+		(*bond_cnt) = -EIO;
+	} else {
+		(*bond_cnt)++;
+	}
+}
+
+#if !defined(CONFIG_BOND_MGR)
+static void rebuild_cb(const struct bt_bond_info *info, void *user_data)
+{
+	rebuild_add(&info->addr, user_data);
+}
+#endif
+
+static int rebuild(uint8_t local_id)
+{
+	int64_t start = k_uptime_ticks();
+	int bond_cnt = 0;
+	int err;
+
+	err = bt_le_filter_accept_list_clear();
+	pending_cmds++;
+	if (err) {
+		LOG_INF("Cannot clear accept list (err: %d)\n", err);
+		return err;
+	}
+
+#if defined(CONFIG_BOND_MGR)
+	/* More bonds than controller entries, list the most recently used ones */
+	bt_addr_le_t recent[CONFIG_BOND_MGR_ACCEPT_LIST_SIZE];
+	size_t n = bond_mgr_recent(recent, ARRAY_SIZE(recent));
+
+	for (size_t i = 0; i < n; i++) {
+		rebuild_add(&recent[i], &bond_cnt);
+	}
+#else
+	bt_foreach_bond(local_id, rebuild_cb, &bond_cnt);
+#endif
+
+	rebuild_us = k_ticks_to_us_floor32(k_uptime_ticks() - start);
+	rebuild_cmds = 1 + MAX(bond_cnt, 0);
+
+	return bond_cnt;
+}
+
+static void count_bond_cb(const struct bt_bond_info *info, void *user_data)
+{
+	(*(uint32_t *)user_data)++;
+}
+
+#if defined(CONFIG_BT_PRIVACY)
+static int read_rl_size(void)
+{
+	struct bt_hci_rp_le_read_rl_size *rp;
+	struct net_buf *rsp;
+	int err;
+
+	err = bt_hci_cmd_send_sync(BT_HCI_OP_LE_READ_RL_SIZE, NULL, &rsp);
+	if (err) {
+		LOG_INF("Cannot read resolving list size (err: %d)\n", err);
+		return err;
+	}
+
+	rp = (void *)rsp->data;
+	err = rp->rl_size;
+	net_buf_unref(rsp);
+
+	return err;
+}
+#endif
+
+int accept_list_sync(uint8_t local_id)
+{
+	uint32_t bonds = 0;
+	uint32_t saved;
+
+	bt_foreach_bond(local_id, count_bond_cb, &bonds);
+
+#if defined(CONFIG_BT_PRIVACY)
+	/* With more bonds than resolving list entries the host turns off address resolution
+	 * in the controller, which then cannot match a private address against the list.
+	 */
+	if (rl_size < 0) {
+		rl_size = read_rl_size();
+	}
+
+	host_filter = (rl_size >= 0 && bonds > rl_size);
+	if (host_filter) {
+		LOG_INF("Accept list: %u bonds for %d resolving list entries, filtering in the host\n",
+			bonds, rl_size);
+		return 0;
+	}
+#endif
+
+	if (!synced) {
+		entries = rebuild(local_id);
+		synced = (entries >= 0);
+	}
+
+	/* What rebuilding on every advertising start would have cost */
+#if defined(CONFIG_BOND_MGR)
+	total_cmds_rebuild += 1 + MIN(bonds, CONFIG_BOND_MGR_ACCEPT_LIST_SIZE);
+#else
+	total_cmds_rebuild += 1 + bonds;
+#endif
+	total_cmds += pending_cmds;
+	pending_cmds = 0;
+
+	saved = (total_cmds_rebuild > total_cmds) ? (total_cmds_rebuild - total_cmds) : 0;
+	LOG_INF("Accept list: %d of %u bonds, %u HCI commands saved so far, about %u us",
+		entries, bonds, saved, rebuild_cmds ? (saved * rebuild_us) / rebuild_cmds : 0);
+
+	return entries;
+}
+
+void accept_list_add(const bt_addr_le_t *addr)
+{
+	int err;
+
+	if (!synced) {
+		return;
+	}
+
+#if defined(CONFIG_BOND_MGR)
+	if (entries >= CONFIG_BOND_MGR_ACCEPT_LIST_SIZE) {
+		/* The least recently used entry has to go, rebuild from the bond order */
+		synced = false;
+		return;
+	}
+#endif
+
+	err = bt_le_filter_accept_list_add(addr);
+	pending_cmds++;
+	if (err) {
+		LOG_INF("Cannot add peer to filter accept list (err: %d)\n", err);
+		synced = false;
+		return;
+	}
+
+	entries++;
+}
+
+void accept_list_remove(const bt_addr_le_t *addr)
+{
+	int err;
+
+	if (!synced) {
+		return;
+	}
+
+	if (bt_addr_le_eq(addr, BT_ADDR_LE_ANY)) {
+		err = bt_le_filter_accept_list_clear();
+	} else {
+		err = bt_le_filter_accept_list_remove(addr);
+	}
+	pending_cmds++;
+
+	if (err) {
+		/* The controller refuses changes while advertising uses the list */
+		LOG_INF("Cannot remove peer from filter accept list (err: %d)\n", err);
+		synced = false;
+		return;
+	}
+
+	entries = bt_addr_le_eq(addr, BT_ADDR_LE_ANY) ? 0 : MAX(entries - 1, 0);
+}
+
+void accept_list_invalidate(void)
+{
+	synced = false;
+}
+
+bool accept_list_host_filter(void)
+{
+	return host_filter;
+}
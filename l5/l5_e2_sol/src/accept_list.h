@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef ACCEPT_LIST_H_
+#define ACCEPT_LIST_H_
+
+/**@file
+ * @defgroup accept_list Filter Accept List maintenance
+ * @{
+ * @brief Keep the controller Filter Accept List in sync with the bond list.
+ *
+ * The list is rebuilt from the bonds once after Bluetooth is enabled and then
+ * updated one entry at a time as bonds are added or deleted, so restarting
+ * advertising does not cost one HCI command per bond. If an incremental
+ * update fails, for example because advertising is using the list, the next
+ * accept_list_sync() rebuilds it. With CONFIG_BOND_MGR the list holds only
+ * the CONFIG_BOND_MGR_ACCEPT_LIST_SIZE most recently used bonds.
+ *
+ * With CONFIG_BT_PRIVACY the list only works while the controller resolves
+ * private addresses. The host stops that once there are more bonds than
+ * resolving list entries. The list is then not used, see
+ * accept_list_host_filter().
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <zephyr/types.h>
+#include <zephyr/bluetooth/addr.h>
+
+/** @brief Bring the list in sync before advertising starts.
+ *
+ * Does nothing unless the list has never been built or an incremental update
+ * failed. Logs the HCI commands and time saved compared to rebuilding the
+ * list on every advertising start.
+ *
+ * @param[in] local_id Local identity whose bonds are listed.
+ *
+ * @return Number of entries in the list, or a (negative) error code.
+ */
+int accept_list_sync(uint8_t local_id);
+
+/** @brief Add a newly bonded peer.
+ *
+ * @param[in] addr Identity address of the peer.
+ */
+void accept_list_add(const bt_addr_le_t *addr);
+
+/** @brief Remove a peer whose bond was deleted.
+ *
+ * @param[in] addr Identity address of the peer, or BT_ADDR_LE_ANY for all.
+ */
+void accept_list_remove(const bt_addr_le_t *addr);
+
+/** @brief Force a rebuild on the next accept_list_sync(). */
+void accept_list_invalidate(void);
+
+/** @brief Whether filtering is left to the application.
+ *
+ * True when the last accept_list_sync() found more bonds than resolving list
+ * entries and returned 0, so that advertising runs without the list. The
+ * application then has to disconnect centrals that are not bonded.
+ *
+ * @return true if the application has to filter connections.
+ */
+bool accept_list_host_filter(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ACCEPT_LIST_H_ */
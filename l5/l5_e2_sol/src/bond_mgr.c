@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Least recently used bond management
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+
+#include "bond_mgr.h"
+#include "settings_wb.h"
+
+LOG_MODULE_DECLARE(Lesson5_Exercise2);
+
+#define BOND_MGR_SETTINGS_KEY "bond_mgr/lru"
+
+#if defined(CONFIG_BT_CTLR_FAL_SIZE)
+BUILD_ASSERT(CONFIG_BOND_MGR_ACCEPT_LIST_SIZE <= CONFIG_BT_CTLR_FAL_SIZE,
+	     "More accept list entries than the controller has");
+#endif
+
+#if defined(CONFIG_BT_PRIVACY) && defined(CONFIG_BT_CTLR_RL_SIZE)
+/* Entries of a private peer are only matched while its IRK is in the resolving list */
+BUILD_ASSERT(CONFIG_BOND_MGR_ACCEPT_LIST_SIZE <= CONFIG_BT_CTLR_RL_SIZE,
+	     "More accept list entries than resolving list entries");
+#endif
+
+struct bond_entry {
+	bt_addr_le_t addr;
+	/* Logical timestamp, larger is more recent */
+	uint32_t last_used;
+};
+
+static struct bond_entry table[CONFIG_BT_MAX_PAIRED];
+static size_t count;
+static uint32_t lru_clock;
+
+/* Timestamps read from settings, matched against the bonds in bond_mgr_init() */
+static struct bond_entry stored[CONFIG_BT_MAX_PAIRED];
+static size_t stored_count;
+
+static uint32_t lookups;
+static uint64_t lookup_cycles;
+
+static int bond_mgr_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+	ssize_t ret;
+
+	if (strcmp(name, "lru")) {
+		return -ENOENT;
+	}
+
+	ret = read_cb(cb_arg, stored, MIN(len, sizeof(stored)));
+	if (ret < 0) {
+		return ret;
+	}
+
+	stored_count = ret / sizeof(stored[0]);
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bond_mgr, "bond_mgr", NULL, bond_mgr_set, NULL, NULL);
+
+static int store(void)
+{
+	static struct bond_entry snapshot[CONFIG_BT_MAX_PAIRED];
+	size_t snapshot_count;
+
+	/* The table is only changed from cooperative threads, copying it here is atomic */
+	snapshot_count = count;
+	memcpy(snapshot, table, snapshot_count * sizeof(table[0]));
+
+	return settings_save_one(BOND_MGR_SETTINGS_KEY, snapshot,
+				 snapshot_count * sizeof(snapshot[0]));
+}
+
+static struct settings_wb_entry wb_entry = {
+	.name = BOND_MGR_SETTINGS_KEY,
+	.store = store,
+};
+
+static void save(void)
+{
+	/* Called from the Bluetooth callbacks, the flash write happens later */
+	settings_wb_mark_dirty(&wb_entry);
+}
+
+static struct bond_entry *find(const bt_addr_le_t *addr)
+{
+	uint32_t start = k_cycle_get_32();
+	struct bond_entry *entry = NULL;
+
+	for (size_t i = 0; i < count; i++) {
+		if (bt_addr_le_eq(&table[i].addr, addr)) {
+			entry = &table[i];
+			break;
+		}
+	}
+
+	lookup_cycles += k_cycle_get_32() - start;
+	lookups++;
+
+	return entry;
+}
+
+static size_t rank(const struct bond_entry *entry)
+{
+	size_t newer = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		if (table[i].last_used > entry->last_used) {
+			newer++;
+		}
+	}
+
+	return newer;
+}
+
+static void init_cb(const struct bt_bond_info *info, void *user_data)
+{
+	struct bond_entry *entry;
+
+	if (count >= ARRAY_SIZE(table)) {
+		return;
+	}
+
+	entry = &table[count++];
+	bt_addr_le_copy(&entry->addr, &info->addr);
+	entry->last_used = 0;
+
+	for (size_t i = 0; i < stored_count; i++) {
+		if (bt_addr_le_eq(&stored[i].addr, &info->addr)) {
+			entry->last_used = stored[i].last_used;
+			break;
+		}
+	}
+
+	lru_clock = MAX(lru_clock, entry->last_used);
+}
+
+int bond_mgr_init(uint8_t local_id)
+{
+	count = 0;
+	lru_clock = 0;
+
+	settings_wb_register(&wb_entry);
+
+	bt_foreach_bond(local_id, init_cb, NULL);
+
+	LOG_INF("Bond table: %u of %u entries used\n", count, CONFIG_BT_MAX_PAIRED);
+
+	return count;
+}
+
+void bond_mgr_add(const bt_addr_le_t *addr)
+{
+	struct bond_entry *entry = find(addr);
+
+	if (!entry) {
+		if (count >= ARRAY_SIZE(table)) {
+			/* The host evicts before adding, so this means the tables disagree */
+			LOG_WRN("Bond table full\n");
+			return;
+		}
+
+		entry = &table[count++];
+		bt_addr_le_copy(&entry->addr, addr);
+	}
+
+	entry->last_used = ++lru_clock;
+	save();
+}
+
+bool bond_mgr_touch(const bt_addr_le_t *addr)
+{
+	struct bond_entry *entry = find(addr);
+	bool promoted;
+
+	LOG_INF("Bond lookup: %u entries, %u ns on average over %u lookups\n", count,
+		(uint32_t)k_cyc_to_ns_floor64(lookup_cycles / lookups), lookups);
+
+	if (!entry) {
+		return false;
+	}
+
+	promoted = (rank(entry) >= CONFIG_BOND_MGR_ACCEPT_LIST_SIZE);
+	entry->last_used = ++lru_clock;
+	save();
+
+	return promoted;
+}
+
+void bond_mgr_remove(const bt_addr_le_t *addr)
+{
+	struct bond_entry *entry;
+
+	if (bt_addr_le_eq(addr, BT_ADDR_LE_ANY)) {
+		count = 0;
+		save();
+		return;
+	}
+
+	entry = find(addr);
+	if (!entry) {
+		return;
+	}
+
+	/* Order in the table does not matter, move the last entry into the gap */
+	*entry = table[--count];
+	save();
+
+	LOG_INF("Bond removed, %u bonds left\n", count);
+}
+
+size_t bond_mgr_recent(bt_addr_le_t *addrs, size_t max)
+{
+	uint32_t below = UINT32_MAX;
+	size_t n = 0;
+
+	/* Selection by descending timestamp, the table is small and this runs rarely */
+	while (n < MIN(max, count)) {
+		struct bond_entry *next = NULL;
+
+		for (size_t i = 0; i < count; i++) {
+			if (table[i].last_used < below &&
+			    (!next || table[i].last_used > next->last_used)) {
+				next = &table[i];
+			}
+		}
+
+		if (!next) {
+			break;
+		}
+
+		/* Bonds never used since a reset share timestamp 0, take them all */
+		for (size_t i = 0; i < count && n < max; i++) {
+			if (table[i].last_used == next->last_used) {
+				bt_addr_le_copy(&addrs[n++], &table[i].addr);
+			}
+		}
+
+		below = next->last_used;
+	}
+
+	return n;
+}
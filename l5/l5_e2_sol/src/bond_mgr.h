@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BOND_MGR_H_
+#define BOND_MGR_H_
+
+/**@file
+ * @defgroup bond_mgr Least recently used bond management
+ * @{
+ * @brief Track when each bond was last used.
+ *
+ * Every bond gets a logical timestamp that is bumped whenever the peer
+ * encrypts a connection with it, and the timestamps are kept in settings so
+ * the order survives a reset. The host evicts the least recently used bond
+ * itself when its key table is full (CONFIG_BT_KEYS_OVERWRITE_OLDEST); this
+ * module only mirrors the order so the Filter Accept List can hold the most
+ * recently used bonds when there are more bonds than controller entries.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <zephyr/types.h>
+#include <zephyr/bluetooth/addr.h>
+
+/** @brief Build the table from the bonds loaded from settings.
+ *
+ * Must be called after settings_load().
+ *
+ * @param[in] local_id Local identity whose bonds are tracked.
+ *
+ * @return Number of bonds.
+ */
+int bond_mgr_init(uint8_t local_id);
+
+/** @brief Record a new bond as the most recently used one.
+ *
+ * @param[in] addr Identity address of the peer.
+ */
+void bond_mgr_add(const bt_addr_le_t *addr);
+
+/** @brief Mark a bonded peer as used.
+ *
+ * Unknown peers are ignored.
+ *
+ * @param[in] addr Identity address of the peer.
+ *
+ * @return true if the peer was not among the
+ *         CONFIG_BOND_MGR_ACCEPT_LIST_SIZE most recently used bonds before.
+ */
+bool bond_mgr_touch(const bt_addr_le_t *addr);
+
+/** @brief Forget a deleted bond.
+ *
+ * @param[in] addr Identity address of the peer, or BT_ADDR_LE_ANY for all.
+ */
+void bond_mgr_remove(const bt_addr_le_t *addr);
+
+/** @brief Get the most recently used bonds.
+ *
+ * @param[out] addrs Addresses, most recently used first.
+ * @param[in]  max   Size of @p addrs.
+ *
+ * @return Number of addresses written.
+ */
+size_t bond_mgr_recent(bt_addr_le_t *addrs, size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* BOND_MGR_H_ */
@@ -29,7 +29,8 @@
 LOG_MODULE_REGISTER(bt_lbs, CONFIG_BT_LBS_LOG_LEVEL);
 
 static bool notify_enabled;
-static bool button_state;
+/* Cached Button characteristic value, refreshed by bt_lbs_set_button_state() */
+static atomic_t button_state;
 static struct bt_lbs_cb lbs_cb;
 
 static void lbslc_ccc_cfg_changed(const struct bt_gatt_attr *attr, uint16_t value)
@@ -37,6 +38,17 @@ static void lbslc_ccc_cfg_changed(const struct bt_gatt_attr *attr, uint16_t valu
 	notify_enabled = (value == BT_GATT_CCC_NOTIFY);
 }
 
+static ssize_t lbslc_ccc_cfg_write(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+				   uint16_t value)
+{
+	/* Called on every CCC write, also when a bonded peer rewrites a restored value */
+	if (lbs_cb.subscribe_cb) {
+		lbs_cb.subscribe_cb(conn, value == BT_GATT_CCC_NOTIFY);
+	}
+
+	return sizeof(value);
+}
+
 static ssize_t write_led(struct bt_conn *conn, const struct bt_gatt_attr *attr, const void *buf,
 			 uint16_t len, uint16_t offset, uint8_t flags)
 {
@@ -68,24 +80,23 @@ static ssize_t write_led(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 static ssize_t read_button(struct bt_conn *conn, const struct bt_gatt_attr *attr, void *buf,
 			   uint16_t len, uint16_t offset)
 {
-	const char *value = attr->user_data;
+	/* Serve the cached value so that reads never call into the application and
+	 * concurrent reads from several connections do not race.
+	 */
+	const uint8_t value = atomic_get(&button_state) ? 1U : 0U;
 
 	LOG_DBG("Attribute read, handle: %u, conn: %p", attr->handle, (void *)conn);
 
-	if (lbs_cb.button_cb) {
-		button_state = lbs_cb.button_cb();
-		return bt_gatt_attr_read(conn, attr, buf, len, offset, value, sizeof(*value));
-	}
-
-	return 0;
+	return bt_gatt_attr_read(conn, attr, buf, len, offset, &value, sizeof(value));
 }
 
 /* LED Button Service Declaration */
 BT_GATT_SERVICE_DEFINE(lbs_svc, BT_GATT_PRIMARY_SERVICE(BT_UUID_LBS),
 		       BT_GATT_CHARACTERISTIC(BT_UUID_LBS_BUTTON,
 					      BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
-					      BT_GATT_PERM_READ, read_button, NULL, &button_state),
-		       BT_GATT_CCC(lbslc_ccc_cfg_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+					      BT_GATT_PERM_READ, read_button, NULL, NULL),
+		       BT_GATT_CCC_WITH_WRITE_CB(lbslc_ccc_cfg_changed, lbslc_ccc_cfg_write,
+						 BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
 		       BT_GATT_CHARACTERISTIC(BT_UUID_LBS_LED, BT_GATT_CHRC_WRITE,
 					      BT_GATT_PERM_WRITE_AUTHEN, NULL, write_led, NULL), );
 
@@ -94,16 +105,41 @@ int bt_lbs_init(struct bt_lbs_cb *callbacks)
 	if (callbacks) {
 		lbs_cb.led_cb = callbacks->led_cb;
 		lbs_cb.button_cb = callbacks->button_cb;
+		lbs_cb.subscribe_cb = callbacks->subscribe_cb;
+		lbs_cb.sent_cb = callbacks->sent_cb;
+
+		if (lbs_cb.button_cb) {
+			bt_lbs_set_button_state(lbs_cb.button_cb());
+		}
 	}
 
 	return 0;
 }
 
+void bt_lbs_set_button_state(bool button_state_new)
+{
+	atomic_set(&button_state, button_state_new ? 1 : 0);
+}
+
+static void button_sent(struct bt_conn *conn, void *user_data)
+{
+	if (lbs_cb.sent_cb) {
+		lbs_cb.sent_cb(conn);
+	}
+}
+
 int bt_lbs_send_button_state(bool button_state)
 {
+	struct bt_gatt_notify_params params = {
+		.attr = &lbs_svc.attrs[2],
+		.data = &button_state,
+		.len = sizeof(button_state),
+		.func = button_sent,
+	};
+
 	if (!notify_enabled) {
 		return -EACCES;
 	}
 
-	return bt_gatt_notify(NULL, &lbs_svc.attrs[2], &button_state, sizeof(button_state));
+	return bt_gatt_notify_cb(NULL, &params);
 }
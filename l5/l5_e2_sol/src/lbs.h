@@ -19,6 +19,8 @@ extern "C" {
 
 #include <zephyr/types.h>
 
+struct bt_conn;
+
 /** @brief LBS Service UUID. */
 #define BT_UUID_LBS_VAL BT_UUID_128_ENCODE(0x00001523, 0x1212, 0xefde, 0x1523, 0x785feabcd123)
 
@@ -39,12 +41,22 @@ typedef void (*led_cb_t)(const bool led_state);
 /** @brief Callback type for when the button state is pulled. */
 typedef bool (*button_cb_t)(void);
 
+/** @brief Callback type for when a client writes the Button CCC descriptor. */
+typedef void (*subscribe_cb_t)(struct bt_conn *conn, bool enabled);
+
+/** @brief Callback type for when a Button notification has been sent. */
+typedef void (*sent_cb_t)(struct bt_conn *conn);
+
 /** @brief Callback struct used by the LBS Service. */
 struct bt_lbs_cb {
 	/** LED state change callback. */
 	led_cb_t led_cb;
-	/** Button read callback. */
+	/** Button state callback, called once at init to seed the cached value. */
 	button_cb_t button_cb;
+	/** Button notification subscription callback. */
+	subscribe_cb_t subscribe_cb;
+	/** Button notification sent callback. */
+	sent_cb_t sent_cb;
 };
 
 /** @brief Initialize the LBS Service.
@@ -66,6 +78,15 @@ struct bt_lbs_cb {
  */
 int bt_lbs_init(struct bt_lbs_cb *callbacks);
 
+/** @brief Update the cached button state.
+ *
+ * The Button characteristic is read from this cache, so the application
+ * must call this function whenever the button changes state.
+ *
+ * @param[in] button_state_new The new state of the button.
+ */
+void bt_lbs_set_button_state(bool button_state_new);
+
 /** @brief Send the button state.
  *
  * This function sends a binary state, typically the state of a
@@ -10,9 +10,16 @@
 #include <zephyr/bluetooth/gatt.h>
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/hci.h>
 #include <dk_buttons_and_leds.h>
 
 #include "lbs.h"
+#include "accept_list.h"
+#include "bond_mgr.h"
+#include "rpa_stats.h"
+#include "settings_wb.h"
+#include "pairing_window.h"
+#include "session_cache.h"
 
 LOG_MODULE_REGISTER(Lesson5_Exercise2, LOG_LEVEL_INF);
 
@@ -45,6 +52,39 @@ static bool pairing_mode = false;
 static bool app_button_state;
 static struct k_work adv_work;
 
+/* Uptime of the last connection, used to time how fast the central resumes */
+static int64_t conn_start_time;
+static bool first_notify_pending;
+static struct k_work notify_work;
+
+/* Last bonded peer, which gets a burst of directed advertising after disconnection */
+static bt_addr_le_t last_peer;
+static bool last_peer_valid;
+static bool directed_pending;
+static bool directed_active;
+static int64_t disconnect_time;
+
+/* With the pairing window, recycled_cb() also runs when that set stops, so keep
+ * track of whether the legacy set still advertises or a central is connected.
+ */
+static bool adv_running;
+static bool conn_active;
+/* The running advertising is meant for pairing and accepts any central */
+static bool pairing_adv;
+
+/* Time from connection to encryption, with the session cache outcome */
+static int64_t encrypt_start;
+static bool session_hit;
+
+/* Boot phases in ms of uptime, which counts from kernel start; 0 until reached */
+static struct {
+	int64_t main;
+	int64_t bt_enabled;
+	int64_t settings_loaded;
+	int64_t first_adv;
+} boot;
+static atomic_t boot_reported;
+
 static const struct bt_data ad[] = {
 	BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
 	BT_DATA(BT_DATA_NAME_COMPLETE, DEVICE_NAME, DEVICE_NAME_LEN),
@@ -55,55 +95,59 @@ static const struct bt_data sd[] = {
 };
 
 
-
-/* STEP 3.3.1 - Define the callback to add addresses to the Accept List */
-static void setup_accept_list_cb(const struct bt_bond_info *info, void *user_data)
+static void boot_report(void)
 {
-	int *bond_cnt = user_data;
-
-	if ((*bond_cnt) < 0) {
+	/* Advertising may start before or after the settings are loaded */
+	if (!boot.first_adv || !boot.settings_loaded || !atomic_cas(&boot_reported, 0, 1)) {
 		return;
 	}
 
-	int err = bt_le_filter_accept_list_add(&info->addr);
-	LOG_INF("Added following peer to accept list: %x %x\n", info->addr.a.val[0],
-		info->addr.a.val[1]);
-	if (err) {
-		LOG_INF("Cannot add peer to filter accept list (err: %d)\n", err);
-		(*bond_cnt) = -EIO;
-	} else {
-		(*bond_cnt)++;
-	}
+	LOG_INF("Boot: main %lld ms, bt_enable %lld ms, settings loaded %lld ms, "
+		"first advertisement %lld ms after kernel start\n",
+		boot.main, boot.bt_enabled, boot.settings_loaded, boot.first_adv);
 }
 
-/* STEP 3.3.2 - Define the function to loop through the bond list */
-static int setup_accept_list(uint8_t local_id)
+static void boot_adv_started(void)
 {
-	int err = bt_le_filter_accept_list_clear();
-
-	if (err) {
-		LOG_INF("Cannot clear accept list (err: %d)\n", err);
-		return err;
+	if (!boot.first_adv) {
+		boot.first_adv = k_uptime_get();
+		boot_report();
 	}
+}
 
-	int bond_cnt = 0;
-
-	bt_foreach_bond(local_id, setup_accept_list_cb, &bond_cnt);
+static int adv_stop(void)
+{
+	adv_running = false;
 
-	return bond_cnt;
+	return bt_le_adv_stop();
 }
 
 static void adv_work_handler(struct k_work *work)
 {
 	int err = 0;
+
+	if (IS_ENABLED(CONFIG_PAIRING_WINDOW) && (adv_running || conn_active)) {
+		return;
+	}
+
+	if (IS_ENABLED(CONFIG_DIRECTED_RECONNECT) && directed_pending) {
+		directed_pending = false;
+		/* High duty cycle, the controller stops it after 1.28 s and recycled_cb()
+		 * brings this handler back for the filtered advertising below.
+		 */
+		err = bt_le_adv_start(BT_LE_ADV_CONN_DIR(&last_peer), NULL, 0, NULL, 0);
+		if (!err) {
+			directed_active = true;
+			adv_running = true;
+			pairing_adv = false;
+			LOG_INF("Directed advertising to the last bonded peer\n");
+			return;
+		}
+		LOG_INF("Directed advertising failed to start (err %d)\n", err);
+	}
 /* STEP 4.2.3 Advertise without using Accept List when pairing_mode is set to true */
 	if (pairing_mode==true) {
-		err = bt_le_filter_accept_list_clear();
-		if (err) {
-			LOG_INF("Cannot clear accept list (err: %d)\n", err);
-		} else {
-			LOG_INF("Accept list cleared succesfully");
-		}
+		/* Advertising without the filter policy ignores the list, so it is left as is */
 		pairing_mode = false;
 		err = bt_le_adv_start(BT_LE_ADV_CONN_FAST_2, ad, ARRAY_SIZE(ad), sd,
 				      ARRAY_SIZE(sd));
@@ -112,6 +156,9 @@ static void adv_work_handler(struct k_work *work)
 			return;
 		}
 		LOG_INF("Advertising successfully started\n");
+		adv_running = true;
+		pairing_adv = true;
+		boot_adv_started();
 		return;
 	}
 /* STEP 3.4.1 - Remove the original advertising code */
@@ -124,7 +171,7 @@ static void adv_work_handler(struct k_work *work)
 	//LOG_INF("Advertising successfully started\n");
 
 /* STEP 3.4.2 - Start advertising with the Accept List */
-	int allowed_cnt = setup_accept_list(BT_ID_DEFAULT);
+	int allowed_cnt = accept_list_sync(BT_ID_DEFAULT);
 	if (allowed_cnt < 0) {
 		LOG_INF("Acceptlist setup failed (err:%d)\n", allowed_cnt);
 	} else {
@@ -143,6 +190,9 @@ static void adv_work_handler(struct k_work *work)
 			return;
 		}
 		LOG_INF("Advertising successfully started\n");
+		adv_running = true;
+		pairing_adv = false;
+		boot_adv_started();
 	}
 
 }
@@ -152,14 +202,60 @@ static void advertising_start(void)
 	k_work_submit(&adv_work);
 }
 
+static bool is_bonded(const bt_addr_le_t *addr);
+
 static void on_connected(struct bt_conn *conn, uint8_t err)
 {
 	if (err) {
 		LOG_INF("Connection failed (err %u)\n", err);
+		/* Also the end of a directed advertising burst nobody answered */
+		directed_active = false;
+		adv_running = false;
 		return;
 	}
 
 	LOG_INF("Connected\n");
+	conn_start_time = k_uptime_get();
+	first_notify_pending = true;
+	if (disconnect_time) {
+		LOG_INF("Reconnected %lld ms after disconnection, %s advertising\n",
+			conn_start_time - disconnect_time, directed_active ? "directed" : "undirected");
+		disconnect_time = 0;
+	}
+	directed_active = false;
+	adv_running = false;
+	conn_active = true;
+
+	/* Advertising ran without the accept list, keep unknown centrals out here */
+	if (accept_list_host_filter() && !pairing_adv &&
+	    !(IS_ENABLED(CONFIG_PAIRING_WINDOW) && pairing_window_is_open()) &&
+	    !is_bonded(bt_conn_get_dst(conn))) {
+		LOG_INF("Not bonded and not in pairing mode, disconnecting\n");
+		bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN);
+		return;
+	}
+
+	encrypt_start = k_uptime_ticks();
+	session_hit = false;
+	if (IS_ENABLED(CONFIG_SESSION_CACHE)) {
+		bt_security_t level;
+
+		/* Ask for encryption right away instead of waiting for the central */
+		session_hit = session_cache_get(bt_conn_get_dst(conn), &level);
+		if (session_hit) {
+			bt_conn_set_security(conn, level);
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_PAIRING_WINDOW)) {
+		/* One central at a time, whichever set it connected through */
+		pairing_window_close();
+		bt_le_adv_stop();
+	}
+
+	if (IS_ENABLED(CONFIG_RPA_STATS)) {
+		rpa_stats_connected(conn);
+	}
 
 	dk_set_led_on(CON_STATUS_LED);
 }
@@ -168,6 +264,15 @@ static void on_disconnected(struct bt_conn *conn, uint8_t reason)
 {
 	LOG_INF("Disconnected (reason %u)\n", reason);
 	dk_set_led_off(CON_STATUS_LED);
+
+	disconnect_time = k_uptime_get();
+	conn_active = false;
+	directed_pending = IS_ENABLED(CONFIG_DIRECTED_RECONNECT) && last_peer_valid;
+
+	if (IS_ENABLED(CONFIG_SETTINGS_WB)) {
+		/* Store what changed during the connection before the next one starts */
+		settings_wb_flush();
+	}
 }
 
 static void recycled_cb(void)
@@ -176,6 +281,38 @@ static void recycled_cb(void)
 	advertising_start();
 }
 
+struct bond_match {
+	const bt_addr_le_t *addr;
+	bool found;
+};
+
+static void bond_match_cb(const struct bt_bond_info *info, void *user_data)
+{
+	struct bond_match *match = user_data;
+
+	if (bt_addr_le_eq(&info->addr, match->addr)) {
+		match->found = true;
+	}
+}
+
+static bool is_bonded(const bt_addr_le_t *addr)
+{
+	struct bond_match match = {
+		.addr = addr,
+	};
+
+	/* Encryption alone does not tell whether the keys were kept */
+	bt_foreach_bond(BT_ID_DEFAULT, bond_match_cb, &match);
+
+	return match.found;
+}
+
+static void last_peer_set(const bt_addr_le_t *addr, bool bonded)
+{
+	bt_addr_le_copy(&last_peer, addr);
+	last_peer_valid = bonded;
+}
+
 static void on_security_changed(struct bt_conn *conn, bt_security_t level, enum bt_security_err err)
 {
 	char addr[BT_ADDR_LE_STR_LEN];
@@ -184,6 +321,25 @@ static void on_security_changed(struct bt_conn *conn, bt_security_t level, enum
 
 	if (!err) {
 		LOG_INF("Security changed: %s level %u\n", addr, level);
+		LOG_INF("Encrypted %u us after connection, session cache %s\n",
+			k_ticks_to_us_floor32(k_uptime_ticks() - encrypt_start),
+			!IS_ENABLED(CONFIG_SESSION_CACHE) ? "off" : (session_hit ? "hit" : "miss"));
+
+		/* A cache hit already means the peer is bonded */
+		bool bonded = session_hit || is_bonded(bt_conn_get_dst(conn));
+
+		if (IS_ENABLED(CONFIG_SESSION_CACHE) && bonded) {
+			session_cache_put(bt_conn_get_dst(conn), level);
+		}
+		/* A bond used again may have to replace another one in the accept list */
+		if (IS_ENABLED(CONFIG_BOND_MGR) && bond_mgr_touch(bt_conn_get_dst(conn))) {
+			accept_list_invalidate();
+		}
+		if (IS_ENABLED(CONFIG_DIRECTED_RECONNECT)) {
+			last_peer_set(bt_conn_get_dst(conn), bonded);
+		}
+		/* A bonded central's stored subscription is active again once encrypted */
+		k_work_submit(&notify_work);
 	} else {
 		LOG_INF("Security failed: %s level %u err %d\n", addr, level, err);
 	}
@@ -218,6 +374,45 @@ static struct bt_conn_auth_cb conn_auth_callbacks = {
 	.cancel = auth_cancel,
 };
 
+static void pairing_complete(struct bt_conn *conn, bool bonded)
+{
+	if (bonded) {
+		if (IS_ENABLED(CONFIG_BOND_MGR)) {
+			bond_mgr_add(bt_conn_get_dst(conn));
+		}
+		/* Advertising stopped when the central connected, so the list can be changed */
+		accept_list_add(bt_conn_get_dst(conn));
+		if (IS_ENABLED(CONFIG_SESSION_CACHE)) {
+			session_cache_put(bt_conn_get_dst(conn), bt_conn_get_security(conn));
+		}
+		if (IS_ENABLED(CONFIG_DIRECTED_RECONNECT)) {
+			last_peer_set(bt_conn_get_dst(conn), true);
+		}
+	}
+}
+
+static void bond_deleted(uint8_t id, const bt_addr_le_t *peer)
+{
+	/* Also called when the host evicts the least recently used bond */
+	if (IS_ENABLED(CONFIG_BOND_MGR)) {
+		bond_mgr_remove(peer);
+	}
+	accept_list_remove(peer);
+	if (IS_ENABLED(CONFIG_SESSION_CACHE)) {
+		session_cache_invalidate(peer);
+	}
+
+	if (bt_addr_le_eq(peer, BT_ADDR_LE_ANY) || bt_addr_le_eq(peer, &last_peer)) {
+		last_peer_valid = false;
+		directed_pending = false;
+	}
+}
+
+static struct bt_conn_auth_info_cb conn_auth_info_callbacks = {
+	.pairing_complete = pairing_complete,
+	.bond_deleted = bond_deleted,
+};
+
 static void app_led_cb(bool led_state)
 {
 	dk_set_led(USER_LED, led_state);
@@ -228,9 +423,37 @@ static bool app_button_cb(void)
 	return app_button_state;
 }
 
+static void notify_work_handler(struct k_work *work)
+{
+	/* Gives a new subscriber the current state, fails quietly without subscribers */
+	bt_lbs_send_button_state(app_button_state);
+}
+
+static void app_subscribe_cb(struct bt_conn *conn, bool enabled)
+{
+	LOG_INF("Button notifications %s", enabled ? "enabled" : "disabled");
+
+	/* Sent from a work item, once the CCC write has been stored */
+	if (enabled) {
+		k_work_submit(&notify_work);
+	}
+}
+
+static void app_sent_cb(struct bt_conn *conn)
+{
+	/* With GATT caching a bonded central skips discovery, so this comes sooner */
+	if (first_notify_pending) {
+		first_notify_pending = false;
+		LOG_INF("First button notification sent %lld ms after connection",
+			k_uptime_get() - conn_start_time);
+	}
+}
+
 static struct bt_lbs_cb lbs_callbacs = {
 	.led_cb = app_led_cb,
 	.button_cb = app_button_cb,
+	.subscribe_cb = app_subscribe_cb,
+	.sent_cb = app_sent_cb,
 };
 
 static void button_changed(uint32_t button_state, uint32_t has_changed)
@@ -240,12 +463,19 @@ static void button_changed(uint32_t button_state, uint32_t has_changed)
 
 		bt_lbs_send_button_state(user_button_state);
 		app_button_state = user_button_state ? true : false;
+		bt_lbs_set_button_state(app_button_state);
 	}
 	/* STEP 2.2 - Add extra button handling to remove bond information */
 	if (has_changed & BOND_DELETE_BUTTON) {
 		uint32_t bond_delete_button_state = button_state & BOND_DELETE_BUTTON;
 		if (bond_delete_button_state == 0) {
+			/* Stop advertising first, the accept list cannot change while it is in use */
+			adv_stop();
 			int err = bt_unpair(BT_ID_DEFAULT, BT_ADDR_LE_ANY);
+			/* Whatever bt_unpair() managed to delete, no cached session may outlive it */
+			if (IS_ENABLED(CONFIG_SESSION_CACHE)) {
+				session_cache_invalidate(BT_ADDR_LE_ANY);
+			}
 			if (err) {
 				LOG_INF("Cannot delete bond (err: %d)\n", err);
 			} else {
@@ -256,9 +486,12 @@ static void button_changed(uint32_t button_state, uint32_t has_changed)
 	/* STEP 4.2.2 Add extra button handling pairing mode (advertise without using Accept List) */
 	if (has_changed & PAIRING_BUTTON) {
 		uint32_t pairing_button_state = button_state & PAIRING_BUTTON;
-		if (pairing_button_state == 0) {
+		if (pairing_button_state == 0 && IS_ENABLED(CONFIG_PAIRING_WINDOW)) {
+			/* Filtered advertising keeps running, so bonded centrals see no gap */
+			pairing_window_open();
+		} else if (pairing_button_state == 0) {
 			pairing_mode = true;
-			int err_code = bt_le_adv_stop();
+			int err_code = adv_stop();
 			if (err_code) {
 				LOG_INF("Cannot stop advertising err= %d \n", err_code);
 				return;
@@ -285,6 +518,7 @@ int main(void)
 	int blink_status = 0;
 	int err;
 
+	boot.main = k_uptime_get();
 	LOG_INF("Starting Lesson 5 - Exercise 2");
 
 	err = dk_leds_init();
@@ -303,6 +537,11 @@ int main(void)
 		LOG_INF("Failed to register authorization callbacks.\n");
 		return -1;
 	}
+	err = bt_conn_auth_info_cb_register(&conn_auth_info_callbacks);
+	if (err) {
+		LOG_INF("Failed to register authorization info callbacks.\n");
+		return -1;
+	}
 	bt_conn_cb_register(&connection_callbacks);
 
 	err = bt_enable(NULL);
@@ -311,11 +550,9 @@ int main(void)
 		return -1;
 	}
 
+	boot.bt_enabled = k_uptime_get();
 	LOG_INF("Bluetooth initialized\n");
 
-	/* STEP 1.3 - Add setting load function */
-	settings_load();
-
 	err = bt_lbs_init(&lbs_callbacs);
 	if (err) {
 		LOG_INF("Failed to init LBS (err:%d)\n", err);
@@ -323,7 +560,44 @@ int main(void)
 	}
 
 	k_work_init(&adv_work, adv_work_handler);
-	advertising_start();
+	k_work_init(&notify_work, notify_work_handler);
+
+	if (IS_ENABLED(CONFIG_FAST_START)) {
+		/* The identity address, the bonds and their order are needed to advertise
+		 * with the accept list, the rest of the settings can wait.
+		 */
+		settings_load_subtree("bt");
+		if (IS_ENABLED(CONFIG_BOND_MGR)) {
+			settings_load_subtree("bond_mgr");
+			bond_mgr_init(BT_ID_DEFAULT);
+		}
+		advertising_start();
+	} else {
+		/* STEP 1.3 - Add setting load function */
+		settings_load();
+		if (IS_ENABLED(CONFIG_BOND_MGR)) {
+			bond_mgr_init(BT_ID_DEFAULT);
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_RPA_STATS)) {
+		rpa_stats_init(BT_ID_DEFAULT);
+	}
+
+	boot.settings_loaded = k_uptime_get();
+	boot_report();
+
+	/* Creating an advertising set needs the identity from the settings */
+	if (IS_ENABLED(CONFIG_PAIRING_WINDOW)) {
+		err = pairing_window_init(ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+		if (err) {
+			return -1;
+		}
+	}
+
+	if (!IS_ENABLED(CONFIG_FAST_START)) {
+		advertising_start();
+	}
 
 	for (;;) {
 		dk_set_led(RUN_STATUS_LED, (++blink_status) % 2);
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Pairing window
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+
+#include "pairing_window.h"
+
+LOG_MODULE_DECLARE(Lesson5_Exercise2);
+
+/* Start timeout is in 10 ms units */
+#define WINDOW_TIMEOUT (CONFIG_PAIRING_WINDOW_DURATION_S * 100)
+
+/* Legacy PDUs so every central can see the set, no filter policy */
+static const struct bt_le_adv_param *window_adv_param = BT_LE_ADV_PARAM(
+	BT_LE_ADV_OPT_CONN, BT_GAP_ADV_FAST_INT_MIN_2, BT_GAP_ADV_FAST_INT_MAX_2, NULL);
+
+static struct bt_le_ext_adv *adv_set;
+static bool window_open;
+
+static void window_connected(struct bt_le_ext_adv *adv, struct bt_le_ext_adv_connected_info *info)
+{
+	/* Left open until the connected callback has seen it and closes the window */
+	LOG_INF("Central connected through the pairing window\n");
+}
+
+static void window_sent(struct bt_le_ext_adv *adv, struct bt_le_ext_adv_sent_info *info)
+{
+	/* Only called when the set stops by itself, that is when the timeout expires */
+	window_open = false;
+	LOG_INF("Pairing window closed\n");
+}
+
+static const struct bt_le_ext_adv_cb window_cb = {
+	.connected = window_connected,
+	.sent = window_sent,
+};
+
+int pairing_window_init(const struct bt_data *ad, size_t ad_len, const struct bt_data *sd,
+			size_t sd_len)
+{
+	int err;
+
+	err = bt_le_ext_adv_create(window_adv_param, &window_cb, &adv_set);
+	if (err) {
+		LOG_INF("Cannot create pairing window set (err %d)\n", err);
+		return err;
+	}
+
+	err = bt_le_ext_adv_set_data(adv_set, ad, ad_len, sd, sd_len);
+	if (err) {
+		LOG_INF("Cannot set pairing window data (err %d)\n", err);
+	}
+
+	return err;
+}
+
+int pairing_window_open(void)
+{
+	int err;
+
+	if (!adv_set) {
+		return -EAGAIN;
+	}
+
+	if (window_open) {
+		pairing_window_close();
+	}
+
+	err = bt_le_ext_adv_start(adv_set, BT_LE_EXT_ADV_START_PARAM(WINDOW_TIMEOUT, 0));
+	if (err) {
+		LOG_INF("Cannot open pairing window (err %d)\n", err);
+		return err;
+	}
+
+	window_open = true;
+	LOG_INF("Pairing window open for %d s, filtered advertising keeps running\n",
+		CONFIG_PAIRING_WINDOW_DURATION_S);
+
+	return 0;
+}
+
+void pairing_window_close(void)
+{
+	int err;
+
+	if (!window_open) {
+		return;
+	}
+
+	err = bt_le_ext_adv_stop(adv_set);
+	if (err) {
+		LOG_INF("Cannot close pairing window (err %d)\n", err);
+		return;
+	}
+
+	window_open = false;
+	LOG_INF("Pairing window closed\n");
+}
+
+bool pairing_window_is_open(void)
+{
+	return window_open;
+}
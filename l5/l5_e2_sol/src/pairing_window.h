@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef PAIRING_WINDOW_H_
+#define PAIRING_WINDOW_H_
+
+/**@file
+ * @defgroup pairing_window Pairing window
+ * @{
+ * @brief Accept new centrals for a limited time without a gap in advertising.
+ *
+ * A second, unfiltered advertising set runs next to the one filtered by the
+ * accept list while the window is open. Bonded centrals keep reconnecting
+ * through the filtered set, and new ones can connect to pair through the
+ * other one. The controller closes the window when its time is up.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <zephyr/bluetooth/bluetooth.h>
+
+/** @brief Create the advertising set of the window.
+ *
+ * Call after the settings are loaded, creating the set needs the identity.
+ *
+ * @param[in] ad     Advertising data.
+ * @param[in] ad_len Number of elements in @p ad.
+ * @param[in] sd     Scan response data.
+ * @param[in] sd_len Number of elements in @p sd.
+ *
+ * @return 0 on success, or a (negative) error code.
+ */
+int pairing_window_init(const struct bt_data *ad, size_t ad_len, const struct bt_data *sd,
+			size_t sd_len);
+
+/** @brief Open the window for CONFIG_PAIRING_WINDOW_DURATION_S.
+ *
+ * Restarts the time if the window is already open.
+ *
+ * @return 0 on success, -EAGAIN before pairing_window_init(), or another
+ *         (negative) error code.
+ */
+int pairing_window_open(void);
+
+/** @brief Close the window early, for example once a central has connected. */
+void pairing_window_close(void);
+
+/** @brief Whether the window is open.
+ *
+ * Stays true for a central that connected through the window until
+ * pairing_window_close() is called.
+ *
+ * @return true if the window is open.
+ */
+bool pairing_window_is_open(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* PAIRING_WINDOW_H_ */
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Resolvable private address statistics
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/crypto.h>
+#include <zephyr/bluetooth/hci.h>
+
+#include "rpa_stats.h"
+
+LOG_MODULE_DECLARE(Lesson5_Exercise2);
+
+/* IRK checks timed to get the cost of one */
+#define IRK_CHECK_RUNS 16
+
+static uint8_t local_id;
+static uint8_t rl_size;
+static uint32_t irk_check_ns;
+
+static uint32_t controller_resolved;
+static uint32_t host_resolved;
+static uint32_t unresolved;
+
+static int read_rl_size(void)
+{
+	struct bt_hci_rp_le_read_rl_size *rp;
+	struct net_buf *rsp;
+	int err;
+
+	err = bt_hci_cmd_send_sync(BT_HCI_OP_LE_READ_RL_SIZE, NULL, &rsp);
+	if (err) {
+		return err;
+	}
+
+	rp = (void *)rsp->data;
+	rl_size = rp->rl_size;
+	net_buf_unref(rsp);
+
+	return 0;
+}
+
+static void time_irk_check(void)
+{
+	static const uint8_t irk[16] = { 0 };
+	uint8_t block[16] = { 0 };
+	uint32_t start = k_cycle_get_32();
+
+	/* Checking an IRK is one AES-128 block: ah(irk, prand) compared with the hash */
+	for (int i = 0; i < IRK_CHECK_RUNS; i++) {
+		block[15] = i;
+		bt_encrypt_le(irk, block, block);
+	}
+
+	irk_check_ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start) / IRK_CHECK_RUNS;
+}
+
+static void count_bond_cb(const struct bt_bond_info *info, void *user_data)
+{
+	(*(uint32_t *)user_data)++;
+}
+
+static uint32_t bond_count(void)
+{
+	uint32_t bonds = 0;
+
+	bt_foreach_bond(local_id, count_bond_cb, &bonds);
+
+	return bonds;
+}
+
+int rpa_stats_init(uint8_t id)
+{
+	uint32_t bonds;
+	int err;
+
+	local_id = id;
+
+	err = read_rl_size();
+	if (err) {
+		LOG_INF("Cannot read resolving list size (err: %d)\n", err);
+		return err;
+	}
+
+	time_irk_check();
+
+	bonds = bond_count();
+	LOG_INF("Resolving list: %u bonds, %u controller entries, %s resolution expected\n",
+		bonds, rl_size, (bonds > rl_size) ? "host" : "controller");
+	LOG_INF("Host IRK check takes %u ns\n", irk_check_ns);
+
+	return 0;
+}
+
+void rpa_stats_connected(struct bt_conn *conn)
+{
+	struct bt_conn_info info;
+	uint32_t bonds;
+
+	if (bt_conn_get_info(conn, &info) || !bt_addr_le_is_rpa(info.le.remote)) {
+		return;
+	}
+
+	/* The peer connected from a private address, dst is its identity if resolved */
+	if (bt_addr_le_is_rpa(info.le.dst)) {
+		unresolved++;
+		return;
+	}
+
+	/* Which one resolved the address is not reported, so follow the rule of the host */
+	bonds = bond_count();
+	if (bonds > rl_size) {
+		host_resolved++;
+		/* Search stops at the matching bond, halfway on average */
+		LOG_INF("Likely resolved by the host, estimated %u us for %u bonds\n",
+			(bonds * irk_check_ns) / 2000, bonds);
+	} else {
+		controller_resolved++;
+	}
+
+	LOG_INF("Private addresses (inferred): %u resolved by the controller, %u by the host, "
+		"%u unresolved\n", controller_resolved, host_resolved, unresolved);
+}
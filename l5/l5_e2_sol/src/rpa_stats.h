@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef RPA_STATS_H_
+#define RPA_STATS_H_
+
+/**@file
+ * @defgroup rpa_stats Resolvable private address statistics
+ * @{
+ * @brief Count where the addresses of bonded private peers are resolved.
+ *
+ * The host loads the IRK of every bond into the controller resolving list
+ * when the settings are loaded and after each pairing. When there are more
+ * bonds than list entries it turns controller resolution off and resolves
+ * addresses itself, checking the IRKs of the bonds one by one. This module
+ * reads the list size from the controller and counts connections from
+ * private addresses. Neither the host nor the controller reports which of
+ * them resolved an address, so the mode is inferred from the number of
+ * bonds, by the same rule the host follows. The host cost is an estimate
+ * from a timed IRK check, not a measured connection latency.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr/types.h>
+#include <zephyr/bluetooth/conn.h>
+
+/** @brief Read the resolving list size and time one IRK check.
+ *
+ * Must be called after settings_load().
+ *
+ * @param[in] local_id Local identity whose bonds are counted.
+ *
+ * @return 0 on success, or a (negative) error code.
+ */
+int rpa_stats_init(uint8_t local_id);
+
+/** @brief Account for a new connection.
+ *
+ * @param[in] conn Connection that was just established.
+ */
+void rpa_stats_connected(struct bt_conn *conn);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* RPA_STATS_H_ */
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Session cache
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "session_cache.h"
+
+LOG_MODULE_DECLARE(Lesson5_Exercise2);
+
+struct session_entry {
+	bt_addr_le_t addr;
+	bt_security_t level;
+	/* 0 for a free entry, larger is more recent */
+	uint32_t last_used;
+};
+
+static struct session_entry cache[CONFIG_SESSION_CACHE_SIZE];
+static uint32_t use_clock;
+
+static uint32_t hits;
+static uint32_t misses;
+
+static struct session_entry *find(const bt_addr_le_t *addr)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].last_used && bt_addr_le_eq(&cache[i].addr, addr)) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+bool session_cache_get(const bt_addr_le_t *addr, bt_security_t *level)
+{
+	struct session_entry *entry = find(addr);
+
+	if (entry) {
+		hits++;
+		entry->last_used = ++use_clock;
+		if (level) {
+			*level = entry->level;
+		}
+	} else {
+		misses++;
+	}
+
+	LOG_INF("Session cache: %u hits, %u misses\n", hits, misses);
+
+	return (entry != NULL);
+}
+
+void session_cache_put(const bt_addr_le_t *addr, bt_security_t level)
+{
+	struct session_entry *entry = find(addr);
+
+	if (!entry) {
+		/* Free entries have the oldest timestamp of all */
+		entry = &cache[0];
+		for (size_t i = 1; i < ARRAY_SIZE(cache); i++) {
+			if (cache[i].last_used < entry->last_used) {
+				entry = &cache[i];
+			}
+		}
+
+		bt_addr_le_copy(&entry->addr, addr);
+	}
+
+	entry->level = level;
+	entry->last_used = ++use_clock;
+}
+
+void session_cache_invalidate(const bt_addr_le_t *addr)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (bt_addr_le_eq(addr, BT_ADDR_LE_ANY) || bt_addr_le_eq(&cache[i].addr, addr)) {
+			cache[i].last_used = 0;
+		}
+	}
+}
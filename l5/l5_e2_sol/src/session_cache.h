@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SESSION_CACHE_H_
+#define SESSION_CACHE_H_
+
+/**@file
+ * @defgroup session_cache Session cache
+ * @{
+ * @brief Remember the security level of recently connected bonded peers.
+ *
+ * The keys of all bonds are already kept in RAM by the host. What a
+ * reconnection still pays for is finding out whether the peer is bonded and
+ * waiting for the central to start encryption. A hit in this small cache
+ * answers the first without walking the bond list, and lets the peripheral
+ * request the cached security level as soon as the link is up.
+ *
+ * Entries must be invalidated whenever a bond is deleted.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <zephyr/bluetooth/addr.h>
+#include <zephyr/bluetooth/conn.h>
+
+/** @brief Look up a peer and count the hit or miss.
+ *
+ * @param[in]  addr  Identity address of the peer.
+ * @param[out] level Security level of the last session, may be NULL.
+ *
+ * @return true on a hit.
+ */
+bool session_cache_get(const bt_addr_le_t *addr, bt_security_t *level);
+
+/** @brief Add or refresh a bonded peer, replacing the least recently used one.
+ *
+ * @param[in] addr  Identity address of the peer.
+ * @param[in] level Security level reached.
+ */
+void session_cache_put(const bt_addr_le_t *addr, bt_security_t level);
+
+/** @brief Drop a peer whose bond was deleted.
+ *
+ * @param[in] addr Identity address of the peer, or BT_ADDR_LE_ANY for all.
+ */
+void session_cache_invalidate(const bt_addr_le_t *addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* SESSION_CACHE_H_ */
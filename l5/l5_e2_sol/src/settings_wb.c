@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file
+ *  @brief Settings write-back
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "settings_wb.h"
+
+LOG_MODULE_DECLARE(Lesson5_Exercise2);
+
+static sys_slist_t entries = SYS_SLIST_STATIC_INIT(&entries);
+static struct k_spinlock lock;
+
+/* Changes requested and stores done, the difference is flash writes saved */
+static uint32_t requests;
+static uint32_t writes;
+/* Longest store, which the caller would have waited for without write-back */
+static uint32_t max_store_us;
+
+static void flush_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_handler);
+
+static void flush_work_handler(struct k_work *work)
+{
+	struct settings_wb_entry *entry;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&entries, entry, node) {
+		k_spinlock_key_t key = k_spin_lock(&lock);
+		bool dirty = entry->dirty;
+		int64_t start;
+		int err;
+
+		/* Cleared first, a change made while storing marks the entry again */
+		entry->dirty = false;
+		k_spin_unlock(&lock, key);
+
+		if (!dirty) {
+			continue;
+		}
+
+		start = k_uptime_ticks();
+		err = entry->store();
+		max_store_us = MAX(max_store_us, k_ticks_to_us_ceil32(k_uptime_ticks() - start));
+		writes++;
+
+		if (err) {
+			LOG_INF("Cannot store %s (err: %d)\n", entry->name, err);
+			/* A retry, not a new change. Keep the order: later entries wait for it */
+			key = k_spin_lock(&lock);
+			entry->dirty = true;
+			k_spin_unlock(&lock, key);
+			k_work_schedule(&flush_work, K_MSEC(CONFIG_SETTINGS_WB_DELAY_MS));
+			return;
+		}
+	}
+
+	LOG_INF("Settings write-back: %u flash writes saved, %u us longest store kept off the "
+		"Bluetooth callbacks\n", (requests > writes) ? (requests - writes) : 0,
+		max_store_us);
+}
+
+void settings_wb_register(struct settings_wb_entry *entry)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	entry->dirty = false;
+	sys_slist_append(&entries, &entry->node);
+
+	k_spin_unlock(&lock, key);
+}
+
+void settings_wb_mark_dirty(struct settings_wb_entry *entry)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	entry->dirty = true;
+	requests++;
+
+	k_spin_unlock(&lock, key);
+
+	/* Does not push the deadline back, so a busy entry is still stored regularly */
+	k_work_schedule(&flush_work, K_MSEC(CONFIG_SETTINGS_WB_DELAY_MS));
+}
+
+void settings_wb_flush(void)
+{
+	k_work_reschedule(&flush_work, K_NO_WAIT);
+}
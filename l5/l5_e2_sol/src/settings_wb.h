@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SETTINGS_WB_H_
+#define SETTINGS_WB_H_
+
+/**@file
+ * @defgroup settings_wb Settings write-back
+ * @{
+ * @brief Debounce and batch settings writes made from Bluetooth callbacks.
+ *
+ * A value owner registers an entry with a store function and marks it dirty
+ * instead of writing to flash from the callback. Dirty entries are stored
+ * from the system workqueue CONFIG_SETTINGS_WB_DELAY_MS after the first
+ * change, or right away when settings_wb_flush() is called, for example on
+ * disconnection. Entries are always stored in the order they were registered,
+ * so an entry that refers to another one must be registered after it.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <zephyr/sys/slist.h>
+
+/** @brief Write-back entry. */
+struct settings_wb_entry {
+	/** Name used in the log. */
+	const char *name;
+	/** Write the current value to settings, called from the system workqueue. */
+	int (*store)(void);
+
+	/* Internal */
+	sys_snode_t node;
+	bool dirty;
+};
+
+/** @brief Add an entry, after all entries registered before it.
+ *
+ * @param[in] entry Entry, must stay valid.
+ */
+void settings_wb_register(struct settings_wb_entry *entry);
+
+/** @brief Schedule a write of a changed entry.
+ *
+ * Can be called from any thread, including the Bluetooth RX thread.
+ *
+ * @param[in] entry Entry whose value changed.
+ */
+void settings_wb_mark_dirty(struct settings_wb_entry *entry);
+
+/** @brief Store all dirty entries as soon as possible. */
+void settings_wb_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* SETTINGS_WB_H_ */
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef AD_STREAM_H_
+#define AD_STREAM_H_
+
+/**@file
+ * @defgroup ad_stream Build-time encoded advertising data
+ * @{
+ * @brief Macros that lay out an advertising payload as an encoded byte stream.
+ *
+ * A payload is described once as an X-macro table taking the stream name and
+ * three entry macros:
+ *
+ * - BYTES(s, name, type, ...) for an AD structure given as a list of bytes,
+ * - STR(s, name, type, str) for an AD structure holding a string without its
+ *   terminating NUL, such as a device name,
+ * - URI(s, name, scheme, str) for a URI whose scheme is given as its
+ *   Bluetooth SIG scheme code, such as AD_STREAM_URI_HTTPS.
+ *
+ * From that table AD_STREAM_DEFINE() emits a packed structure with the
+ * length, type and data of every AD structure in advertising order, checks
+ * at build time that it fits a legacy advertising packet, and emits the
+ * bt_data array the advertising API takes. The array points into the stream,
+ * so dynamic fields are updated by patching their bytes in place.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr/toolchain.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/gap.h>
+
+/** @brief URI scheme code of "http:". */
+#define AD_STREAM_URI_HTTP 0x16
+/** @brief URI scheme code of "https:". */
+#define AD_STREAM_URI_HTTPS 0x17
+
+#define AD_STREAM_STRUCT_BYTES(_s, _name, _type, ...)                                              \
+	struct {                                                                                   \
+		uint8_t len;                                                                       \
+		uint8_t type;                                                                      \
+		uint8_t data[sizeof((uint8_t[]){__VA_ARGS__})];                                    \
+	} __packed _name;
+#define AD_STREAM_STRUCT_STR(_s, _name, _type, _str)                                               \
+	struct {                                                                                   \
+		uint8_t len;                                                                       \
+		uint8_t type;                                                                      \
+		uint8_t data[sizeof(_str) - 1];                                                    \
+	} __packed _name;
+#define AD_STREAM_STRUCT_URI(_s, _name, _scheme, _str)                                             \
+	struct {                                                                                   \
+		uint8_t len;                                                                       \
+		uint8_t type;                                                                      \
+		uint8_t scheme;                                                                    \
+		uint8_t data[sizeof(_str) - 1];                                                    \
+	} __packed _name;
+
+#define AD_STREAM_INIT_BYTES(_s, _name, _type, ...)                                                \
+	._name = {                                                                                 \
+		.len = 1 + sizeof((uint8_t[]){__VA_ARGS__}),                                       \
+		.type = (_type),                                                                   \
+		.data = {__VA_ARGS__},                                                             \
+	},
+#define AD_STREAM_INIT_STR(_s, _name, _type, _str)                                                 \
+	._name = {                                                                                 \
+		.len = sizeof(_str),                                                               \
+		.type = (_type),                                                                   \
+		.data = _str,                                                                      \
+	},
+#define AD_STREAM_INIT_URI(_s, _name, _scheme, _str)                                               \
+	._name = {                                                                                 \
+		.len = 1 + sizeof(_str),                                                           \
+		.type = BT_DATA_URI,                                                               \
+		.scheme = (_scheme),                                                               \
+		.data = _str,                                                                      \
+	},
+
+#define AD_STREAM_BT_DATA_BYTES(_s, _name, _type, ...)                                             \
+	{.type = (_type), .data_len = sizeof(_s._name.data), .data = _s._name.data},
+#define AD_STREAM_BT_DATA_STR(_s, _name, _type, _str)                                              \
+	{.type = (_type), .data_len = sizeof(_s._name.data), .data = _s._name.data},
+#define AD_STREAM_BT_DATA_URI(_s, _name, _scheme, _str)                                            \
+	{.type = BT_DATA_URI, .data_len = 1 + sizeof(_s._name.data), .data = &_s._name.scheme},
+
+/** @brief Define an encoded advertising payload and its bt_data array.
+ *
+ * Defines a static, writable stream named @p _s and a constant array of
+ * bt_data pointing into it, named @p _s with a @c _data suffix. A payload that does not fit a legacy
+ * advertising packet is a build error.
+ *
+ * @param _s     Name of the stream.
+ * @param _table X-macro describing the payload.
+ */
+#define AD_STREAM_DEFINE(_s, _table)                                                               \
+	static struct {                                                                            \
+		_table(_s, AD_STREAM_STRUCT_BYTES, AD_STREAM_STRUCT_STR, AD_STREAM_STRUCT_URI)    \
+	} __packed _s = {                                                                          \
+		_table(_s, AD_STREAM_INIT_BYTES, AD_STREAM_INIT_STR, AD_STREAM_INIT_URI)          \
+	};                                                                                         \
+	BUILD_ASSERT(sizeof(_s) <= BT_GAP_ADV_MAX_ADV_DATA_LEN,                                    \
+		     #_s " does not fit a legacy advertising packet");                             \
+	static const struct bt_data _s##_data[] = {                                                \
+		_table(_s, AD_STREAM_BT_DATA_BYTES, AD_STREAM_BT_DATA_STR, AD_STREAM_BT_DATA_URI)  \
+	}
+
+/** @brief Pointer to the data bytes of an AD structure in a stream. */
+#define AD_STREAM_FIELD(_s, _name) ((_s)._name.data)
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* AD_STREAM_H_ */
@@ -6,53 +6,68 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/bluetooth/bluetooth.h>
 #include <zephyr/bluetooth/gap.h>
 #include <dk_buttons_and_leds.h>
 
+#include "adv_coalesce.h"
+#include "ad_stream.h"
+
 #define COMPANY_ID_CODE 0x0059
 
-typedef struct adv_mfg_data {
-	uint16_t company_code; /* Company Identifier Code. */
-	uint16_t number_press; /* Number of times Button 1 is pressed */
-} adv_mfg_data_type;
+/* Manufacturer data is the Company ID followed by the number of times Button 1 is pressed */
+#define MFG_NUMBER_PRESS_OFFSET 2
 
 #define USER_BUTTON DK_BTN1_MSK
 
+/* Push at most one advertising data update per advertising interval */
+#define ADV_UPDATE_INTERVAL K_MSEC(500)
+
 static const struct bt_le_adv_param *adv_param =
 	BT_LE_ADV_PARAM(BT_LE_ADV_OPT_NONE, /* No options specified */
 			800, /* Min Advertising Interval 500ms (800*0.625ms) */
 			801, /* Max Advertising Interval 500.625ms (801*0.625ms) */
 			NULL); /* Set to NULL for undirected advertising */
 
-static adv_mfg_data_type adv_mfg_data = { COMPANY_ID_CODE, 0x00 };
+static uint16_t number_press;
 
-static unsigned char url_data[] = { 0x17, '/', '/', 'a', 'c', 'a', 'd', 'e', 'm',
-				    'y',  '.', 'n', 'o', 'r', 'd', 'i', 'c', 's',
-				    'e',  'm', 'i', '.', 'c', 'o', 'm' };
 LOG_MODULE_REGISTER(Lesson2_Exercise2, LOG_LEVEL_INF);
 
 #define DEVICE_NAME CONFIG_BT_DEVICE_NAME
-#define DEVICE_NAME_LEN (sizeof(DEVICE_NAME) - 1)
 
 #define RUN_STATUS_LED DK_LED1
 #define RUN_LED_BLINK_INTERVAL 1000
 
-static const struct bt_data ad[] = {
-	BT_DATA_BYTES(BT_DATA_FLAGS, BT_LE_AD_NO_BREDR),
-	BT_DATA(BT_DATA_NAME_COMPLETE, DEVICE_NAME, DEVICE_NAME_LEN),
-	BT_DATA(BT_DATA_MANUFACTURER_DATA, (unsigned char *)&adv_mfg_data, sizeof(adv_mfg_data)),
-};
+/* Advertising and scan response payloads, encoded at build time */
+#define ADV_AD(_s, BYTES, STR, URI)                                                                \
+	BYTES(_s, flags, BT_DATA_FLAGS, BT_LE_AD_NO_BREDR)                                         \
+	STR(_s, name, BT_DATA_NAME_COMPLETE, DEVICE_NAME)                                          \
+	BYTES(_s, mfg, BT_DATA_MANUFACTURER_DATA, BT_BYTES_LIST_LE16(COMPANY_ID_CODE),             \
+	      BT_BYTES_LIST_LE16(0))
+
+#define ADV_SD(_s, BYTES, STR, URI) URI(_s, url, AD_STREAM_URI_HTTPS, "//academy.nordicsemi.com")
+
+AD_STREAM_DEFINE(adv_ad, ADV_AD);
+AD_STREAM_DEFINE(adv_sd, ADV_SD);
 
-static const struct bt_data sd[] = {
-	BT_DATA(BT_DATA_URI, url_data, sizeof(url_data)),
-};
+/* Sets both the advertising and the scan response data */
+#define ADV_PUSH_HCI_CMDS 2
+
+static int push_adv_data(void)
+{
+	return bt_le_adv_update_data(adv_ad_data, ARRAY_SIZE(adv_ad_data), adv_sd_data,
+				     ARRAY_SIZE(adv_sd_data));
+}
 
 static void button_changed(uint32_t button_state, uint32_t has_changed)
 {
 	if (has_changed & button_state & USER_BUTTON) {
-		adv_mfg_data.number_press += 1;
-		bt_le_adv_update_data(ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+		number_press += 1;
+		/* Only the two counter bytes of the encoded payload change */
+		sys_put_le16(number_press,
+			     &AD_STREAM_FIELD(adv_ad, mfg)[MFG_NUMBER_PRESS_OFFSET]);
+		adv_coalesce_mark_dirty();
 	}
 }
 
@@ -80,6 +95,8 @@ int main(void)
 		LOG_ERR("LEDs init failed (err %d)\n", err);
 		return -1;
 	}
+	adv_coalesce_init(push_adv_data, ADV_PUSH_HCI_CMDS, ADV_UPDATE_INTERVAL);
+
 	err = init_button();
 	if (err) {
 		printk("Button init failed (err %d)\n", err);
@@ -94,7 +111,8 @@ int main(void)
 
 	LOG_INF("Bluetooth initialized\n");
 
-	err = bt_le_adv_start(adv_param, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+	err = bt_le_adv_start(adv_param, adv_ad_data, ARRAY_SIZE(adv_ad_data), adv_sd_data,
+			      ARRAY_SIZE(adv_sd_data));
 	if (err) {
 		LOG_ERR("Advertising failed to start (err %d)\n", err);
 		return -1;
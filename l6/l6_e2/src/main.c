@@ -24,6 +24,19 @@
 struct bt_conn *my_conn = NULL;
 static struct k_work adv_work;
 
+/* Advertising interval in 0.625 ms units */
+#define ADV_INTERVAL_FROM_MS(ms) ((ms) * 8U / 5U)
+
+enum adv_phase {
+	ADV_PHASE_FAST,
+	ADV_PHASE_SLOW,
+};
+
+static enum adv_phase adv_phase;
+static int64_t adv_phase_start;
+static struct k_work_delayable adv_phase_work;
+static struct k_work_sync adv_phase_sync;
+
 static const struct bt_le_adv_param *adv_param = BT_LE_ADV_PARAM(
 	(BT_LE_ADV_OPT_CONN |
 	 BT_LE_ADV_OPT_USE_IDENTITY), /* Connectable advertising and use identity address */
@@ -50,10 +63,60 @@ static const struct bt_data sd[] = {
 			  BT_UUID_128_ENCODE(0x00001523, 0x1212, 0xefde, 0x1523, 0x785feabcd123)),
 };
 
+static void adv_sched_start(void)
+{
+	uint32_t interval_ms = (adv_phase == ADV_PHASE_FAST) ? CONFIG_ADV_SCHED_FAST_INTERVAL_MS
+							      : CONFIG_ADV_SCHED_SLOW_INTERVAL_MS;
+	struct bt_le_adv_param param = BT_LE_ADV_PARAM_INIT(
+		(BT_LE_ADV_OPT_CONN | BT_LE_ADV_OPT_USE_IDENTITY),
+		ADV_INTERVAL_FROM_MS(interval_ms), ADV_INTERVAL_FROM_MS(interval_ms), NULL);
+	int err;
+
+	/* Changing the interval requires restarting the advertiser */
+	bt_le_adv_stop();
+
+	err = bt_le_adv_start(&param, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+	if (err) {
+		LOG_ERR("Advertising failed to start (err %d)", err);
+		return;
+	}
+
+	adv_phase_start = k_uptime_get();
+
+	if (adv_phase == ADV_PHASE_FAST) {
+		LOG_INF("Advertising phase fast: %u ms interval for %u s", interval_ms,
+			CONFIG_ADV_SCHED_FAST_DURATION_S);
+		k_work_reschedule(&adv_phase_work, K_SECONDS(CONFIG_ADV_SCHED_FAST_DURATION_S));
+	} else {
+		LOG_INF("Advertising phase slow: %u ms interval", interval_ms);
+	}
+}
+
+static void adv_phase_work_handler(struct k_work *work)
+{
+	if (my_conn) {
+		return;
+	}
+
+	LOG_INF("Fast phase ended after %lld ms without a connection",
+		k_uptime_get() - adv_phase_start);
+	adv_phase = ADV_PHASE_SLOW;
+	k_work_submit(&adv_work);
+}
+
 static void adv_work_handler(struct k_work *work)
 {
-	int err = bt_le_adv_start(adv_param, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
+	int err;
+
+	if (IS_ENABLED(CONFIG_ADV_SCHED)) {
+		/* A phase change queued just before the connection */
+		if (!my_conn) {
+			adv_sched_start();
+		}
+		return;
+	}
 
+	err = bt_le_adv_start(adv_param, ad, ARRAY_SIZE(ad), sd, ARRAY_SIZE(sd));
 	if (err) {
 		LOG_ERR("Advertising failed to start (err %d)", err);
 		return;
@@ -64,6 +127,8 @@ static void adv_work_handler(struct k_work *work)
 
 static void advertising_start(void)
 {
+	/* Every (re)start begins with the fast phase */
+	adv_phase = ADV_PHASE_FAST;
 	k_work_submit(&adv_work);
 }
 
@@ -114,7 +179,15 @@ void on_connected(struct bt_conn *conn, uint8_t err)
 		return;
 	}
 	LOG_INF("Connected");
+	/* Set first, so that no phase change restarts advertising from here on */
 	my_conn = bt_conn_ref(conn);
+	if (IS_ENABLED(CONFIG_ADV_SCHED)) {
+		/* The phase handler may already be running, wait for it to finish */
+		k_work_cancel_delayable_sync(&adv_phase_work, &adv_phase_sync);
+		LOG_INF("Connected %lld ms into the %s advertising phase",
+			k_uptime_get() - adv_phase_start,
+			(adv_phase == ADV_PHASE_FAST) ? "fast" : "slow");
+	}
 	dk_set_led(CONNECTION_STATUS_LED, 1);
 	k_sleep(K_MSEC(100)); 
 	
@@ -137,6 +210,7 @@ void on_disconnected(struct bt_conn *conn, uint8_t reason)
 	LOG_INF("Disconnected. Reason %d", reason);
 	dk_set_led(CONNECTION_STATUS_LED, 0);
 	bt_conn_unref(my_conn);
+	my_conn = NULL;
 }
 
 void on_recycled(void)
@@ -200,6 +274,18 @@ static void button_changed(uint32_t button_state, uint32_t has_changed)
 	if (user_button_changed) {
 		LOG_INF("Button %s", (user_button_pressed ? "pressed" : "released"));
 
+		/* A user interacting with the device is likely to want to connect to it */
+		if (IS_ENABLED(CONFIG_ADV_SCHED) && user_button_pressed && !my_conn) {
+			if (adv_phase == ADV_PHASE_SLOW) {
+				advertising_start();
+			} else {
+				/* The fast phase starts over */
+				adv_phase_start = k_uptime_get();
+				k_work_reschedule(&adv_phase_work,
+						  K_SECONDS(CONFIG_ADV_SCHED_FAST_DURATION_S));
+			}
+		}
+
 		err = bt_lbs_send_button_state(user_button_pressed);
 		if (err) {
 			LOG_ERR("Couldn't send notification. (err: %d)", err);
@@ -251,6 +337,7 @@ int main(void)
 
 	LOG_INF("Bluetooth initialized");
 	k_work_init(&adv_work, adv_work_handler);
+	k_work_init_delayable(&adv_phase_work, adv_phase_work_handler);
 	advertising_start();
 
 	for (;;) {
@@ -145,6 +145,7 @@ static void button_changed(uint32_t button_state, uint32_t has_changed)
 
 		bt_lbs_send_button_state(user_button_state);
 		app_button_state = user_button_state ? true : false;
+		bt_lbs_set_button_state(app_button_state);
 	}
 }
 